@@ -0,0 +1,39 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "AdjacencyIndex.h"
+
+namespace msp {
+
+  const uint64_t AdjacencyIndex::small_matrix_size;
+
+  void AdjacencyIndex::init(unsigned int nbVertices, uint64_t nbEdges)
+  {
+    words = ((uint64_t)nbVertices + 64) / 64;
+
+    uint64_t matrixBytes = ((uint64_t)nbVertices + 1) * words * sizeof(uint64_t);
+    uint64_t edgeBytes   = 2 * nbEdges * sizeof(uint64_t);
+
+    dense = (matrixBytes <= small_matrix_size || matrixBytes <= edgeBytes);
+
+    if (dense) bits.assign(((uint64_t)nbVertices + 1) * words, 0);
+    else std::vector<uint64_t>().swap(bits);
+  }
+
+}
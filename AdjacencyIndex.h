@@ -0,0 +1,83 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#ifndef ADJACENCY_INDEX_H
+#define ADJACENCY_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace msp {
+
+  /**
+   * @brief Constant-time answer to "are i and j adjacent?" for small or dense graphs.
+   *
+   * The index is a bit-matrix with one row of nbWords() words per vertex, so that whole neighborhoods
+   * can be combined with the kernels of BitOps.h. It is only built when it is small, or when the graph
+   * is dense enough for it not to be larger than the edges themselves; otherwise isDense() is false
+   * and the queries are answered by the caller from the sorted adjacency rows.
+   */
+  class AdjacencyIndex {
+
+  private:
+
+    /** @brief the bit-matrix is always used below this size (in bytes) */
+    static const uint64_t small_matrix_size = 16 << 20;
+
+    bool dense;
+
+    /** @brief number of 64-bit words per row */
+    size_t words;
+
+    /** @brief the rows of the adjacency matrix, one after the other */
+    std::vector<uint64_t> bits;
+
+  public:
+
+    AdjacencyIndex() : dense(false), words(0) { }
+
+    /** Prepares the index for the vertices 0..nbVertices and nbEdges edges, the matrix is allocated only if it is worth it. */
+    void init(unsigned int nbVertices, uint64_t nbEdges);
+
+    inline bool isDense() const { return dense; }
+
+    inline size_t nbWords() const { return words; }
+
+    /** Returns the neighborhood of v as a bitset of nbWords() words (requires isDense()). */
+    inline const uint64_t* row(unsigned int v) const { return &bits[v * words]; }
+
+    /** Returns true if the edge i -- j is in the index (requires isDense()). */
+    inline bool contains(unsigned int i, unsigned int j) const
+    {
+      return (bits[i * words + (j >> 6)] >> (j & 63)) & 1;
+    }
+
+    /** Adds the edge i -- j (requires isDense()). */
+    inline void insert(unsigned int i, unsigned int j)
+    {
+      bits[i * words + (j >> 6)] |= (uint64_t)1 << (j & 63);
+      bits[j * words + (i >> 6)] |= (uint64_t)1 << (i & 63);
+    }
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,163 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "BitOps.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BIT_OPS_X86
+#endif
+
+namespace msp {
+
+  /** @brief the kernels, dispatched once */
+  struct PopcountKernels {
+    uint64_t (*and2)(const uint64_t*, const uint64_t*, size_t);
+    const char* name;
+  };
+
+  static inline unsigned int popcount64(uint64_t x)
+  {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (x * 0x0101010101010101ULL) >> 56;
+  }
+
+  static uint64_t and2_portable(const uint64_t* a, const uint64_t* b, size_t n)
+  {
+    uint64_t count = 0;
+    for (size_t i = 0; i < n; i++) count += popcount64(a[i] & b[i]);
+    return count;
+  }
+
+#ifdef BIT_OPS_X86
+
+  __attribute__((target("popcnt")))
+  static uint64_t and2_popcnt(const uint64_t* a, const uint64_t* b, size_t n)
+  {
+    uint64_t count = 0;
+    for (size_t i = 0; i < n; i++) count += __builtin_popcountll(a[i] & b[i]);
+    return count;
+  }
+
+  /** Popcount of the 4 words of v, summed per 64-bit lane (Mula's nibble lookup). */
+  __attribute__((target("avx2")))
+  static inline __m256i popcount256(__m256i v)
+  {
+    const __m256i table = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+
+    __m256i lo = _mm256_and_si256(v, low);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, lo), _mm256_shuffle_epi8(table, hi));
+
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+  }
+
+  __attribute__((target("avx2,popcnt")))
+  static uint64_t and2_avx2(const uint64_t* a, const uint64_t* b, size_t n)
+  {
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+      __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a+i)), _mm256_loadu_si256((const __m256i*)(b+i)));
+      sum = _mm256_add_epi64(sum, popcount256(x));
+    }
+
+    uint64_t count = _mm256_extract_epi64(sum, 0) + _mm256_extract_epi64(sum, 1) + _mm256_extract_epi64(sum, 2) + _mm256_extract_epi64(sum, 3);
+    for (; i < n; i++) count += __builtin_popcountll(a[i] & b[i]);
+    return count;
+  }
+
+  /** Sum of the 8 lanes of v, stored to memory first (the reduce intrinsic warns under -Wall). */
+  __attribute__((target("avx512f")))
+  static inline uint64_t sum512(__m512i v)
+  {
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512((__m512i*)lanes, v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+  }
+
+  __attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+  static uint64_t and2_avx512(const uint64_t* a, const uint64_t* b, size_t n)
+  {
+    __m512i sum = _mm512_setzero_si512();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+      __m512i x = _mm512_and_si512(_mm512_loadu_si512(a+i), _mm512_loadu_si512(b+i));
+      sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+    }
+
+    uint64_t count = sum512(sum);
+    for (; i < n; i++) count += __builtin_popcountll(a[i] & b[i]);
+    return count;
+  }
+
+#endif
+
+  static PopcountKernels select_kernels()
+  {
+#ifdef BIT_OPS_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq"))
+    {
+      PopcountKernels k = { and2_avx512, "avx512" };
+      return k;
+    }
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+      PopcountKernels k = { and2_avx2, "avx2" };
+      return k;
+    }
+
+    if (__builtin_cpu_supports("popcnt"))
+    {
+      PopcountKernels k = { and2_popcnt, "popcnt" };
+      return k;
+    }
+#endif
+
+    PopcountKernels k = { and2_portable, "portable" };
+    return k;
+  }
+
+  static const PopcountKernels& kernels()
+  {
+    static const PopcountKernels selected = select_kernels();
+    return selected;
+  }
+
+  uint64_t popcount_and(const uint64_t* a, const uint64_t* b, size_t n)
+  {
+    return kernels().and2(a, b, n);
+  }
+
+  const char* popcount_kernel_name()
+  {
+    return kernels().name;
+  }
+
+}
@@ -0,0 +1,44 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+
+#ifndef BIT_OPS_H
+#define BIT_OPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace msp {
+
+  /**
+   * @brief Population counts over bitsets of n 64-bit words.
+   *
+   * The kernel is chosen once from the CPU: AVX-512 VPOPCNTDQ, AVX2 (nibble lookup table),
+   * the POPCNT instruction, or portable C++.
+   */
+
+  /** Returns the number of bits set in a & b. */
+  uint64_t popcount_and(const uint64_t* a, const uint64_t* b, size_t n);
+
+  /** Returns the name of the kernel in use (avx512, avx2, popcnt or portable). */
+  const char* popcount_kernel_name();
+
+}
+
+#endif
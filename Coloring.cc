@@ -0,0 +1,165 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "Coloring.h"
+#include "Graph.h"
+#include <algorithm>
+#include <random>
+#include <stdint.h>
+
+namespace msp {
+
+  static const unsigned int NO_COLOR = ~0u;
+
+  unsigned int dsatur_coloring(const Graph& g, std::vector<unsigned int>& color)
+  {
+    unsigned int n = g.getNbNodes();
+
+    color.assign(n+1, NO_COLOR);
+
+    // seen[v] is the bitset of the colors among the neighbors of v, it grows with the number of colors
+    std::vector<std::vector<uint64_t>> seen(n+1);
+    std::vector<unsigned int> saturation(n+1, 0), degree(n+1, 0);
+
+    for (unsigned int v = 1; v <= n; v++)
+      for (unsigned int x: g.neighbors(v)) if (x != v) degree[v]++;
+
+    // bucket s holds the uncolored vertices of saturation s, plus stale entries of the promoted ones
+    std::vector<std::vector<unsigned int>> bucket(n+1);
+
+    for (unsigned int v = n; v >= 1; v--) bucket[0].push_back(v);
+    std::stable_sort(bucket[0].begin(), bucket[0].end(), [&degree](unsigned int a, unsigned int b) { return degree[a] < degree[b]; });
+
+    unsigned int maxSaturation = 0, nbColors = 0;
+
+    for (unsigned int step = 0; step < n; step++)
+    {
+      unsigned int v = 0;
+
+      while (v == 0)
+      {
+        while (bucket[maxSaturation].empty()) maxSaturation--;
+
+        unsigned int x = bucket[maxSaturation].back();
+        bucket[maxSaturation].pop_back();
+
+        if (color[x] == NO_COLOR && saturation[x] == maxSaturation) v = x;
+      }
+
+      // the first color missing from the neighbors
+      unsigned int c = 0;
+      for (size_t w = 0; w < seen[v].size(); w++, c += 64)
+      {
+        if (~seen[v][w]) { c += __builtin_ctzll(~seen[v][w]); break; }
+      }
+
+      color[v] = c;
+      if (c >= nbColors) nbColors = c+1;
+
+      std::vector<uint64_t>().swap(seen[v]);
+
+      for (unsigned int x: g.neighbors(v))
+      {
+        if (x == v || color[x] != NO_COLOR) continue;
+
+        if (seen[x].size() <= (c >> 6)) seen[x].resize((c >> 6) + 1, 0);
+
+        uint64_t bit = (uint64_t)1 << (c & 63);
+        if (seen[x][c >> 6] & bit) continue;
+
+        seen[x][c >> 6] |= bit;
+        bucket[++saturation[x]].push_back(x);
+        if (saturation[x] > maxSaturation) maxSaturation = saturation[x];
+      }
+    }
+
+    return nbColors;
+  }
+
+  unsigned int greedy_coloring(const Graph& g, const std::vector<unsigned int>& order, std::vector<unsigned int>& color)
+  {
+    unsigned int n = g.getNbNodes();
+
+    color.assign(n+1, NO_COLOR);
+
+    // stamp[c] == v when the color c is taken by a neighbor of v
+    std::vector<unsigned int> stamp(n+1, 0);
+    unsigned int nbColors = 0;
+
+    for (unsigned int v: order)
+    {
+      for (unsigned int x: g.neighbors(v)) if (x != v && color[x] != NO_COLOR) stamp[color[x]] = v;
+
+      unsigned int c = 0;
+      while (stamp[c] == v) c++;
+
+      color[v] = c;
+      if (c >= nbColors) nbColors = c+1;
+    }
+
+    return nbColors;
+  }
+
+  /** Numbers the colors by their smallest vertex. */
+  static void renumber_colors(unsigned int n, std::vector<unsigned int>& color)
+  {
+    std::vector<unsigned int> renamed(n+1, NO_COLOR);
+    unsigned int next = 0;
+
+    for (unsigned int v = 1; v <= n; v++)
+    {
+      if (renamed[color[v]] == NO_COLOR) renamed[color[v]] = next++;
+      color[v] = renamed[color[v]];
+    }
+  }
+
+  unsigned int heuristic_coloring(const Graph& g, unsigned int runs, std::vector<unsigned int>& color, unsigned int seed)
+  {
+    unsigned int n = g.getNbNodes();
+
+    unsigned int best = dsatur_coloring(g, color);
+
+    std::mt19937 generator(seed);
+    std::vector<unsigned int> classes, order, candidate;
+    std::vector<std::vector<unsigned int>> members;
+
+    for (unsigned int run = 0; run < runs && best > 1; run++)
+    {
+      members.assign(best, std::vector<unsigned int>());
+      for (unsigned int v = 1; v <= n; v++) members[color[v]].push_back(v);
+
+      classes.resize(best);
+      for (unsigned int c = 0; c < best; c++) classes[c] = c;
+      std::shuffle(classes.begin(), classes.end(), generator);
+
+      order.clear();
+      for (unsigned int c: classes) order.insert(order.end(), members[c].begin(), members[c].end());
+
+      unsigned int nbColors = greedy_coloring(g, order, candidate);
+
+      // ties are kept too: the next run starts from other classes
+      if (nbColors <= best) { best = nbColors; color.swap(candidate); }
+    }
+
+    if (n > 0) renumber_colors(n, color);
+
+    return best;
+  }
+
+}
@@ -0,0 +1,59 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#ifndef COLORING_H
+#define COLORING_H
+
+#include <vector>
+
+namespace msp {
+
+  class Graph;
+
+  /**
+   * @brief DSATUR (Brelaz 1979): colors next the vertex seeing the most distinct colors among its neighbors.
+   *
+   * The vertices wait in a bucket queue indexed by their saturation, those of the same saturation come out
+   * most recently promoted first (the initial bucket by decreasing degree). Each vertex takes the smallest
+   * color none of its neighbors has.
+   *
+   * @param[out] color the color (from 0) of each vertex 1..n, color[0] is unused
+   * @return the number of colors
+   */
+  unsigned int dsatur_coloring(const Graph& g, std::vector<unsigned int>& color);
+
+  /** Greedy coloring in the given order: each vertex takes the smallest color none of its colored neighbors has. */
+  unsigned int greedy_coloring(const Graph& g, const std::vector<unsigned int>& order, std::vector<unsigned int>& color);
+
+  /**
+   * @brief The best coloring found by DSATUR then by a few randomized greedy runs.
+   *
+   * Each greedy run takes the color classes of the best coloring so far in a random order (Culberson's
+   * iterated greedy), so it never uses more colors. The colors are finally numbered by their smallest
+   * vertex, hence the vertex v always has a color below v, as the encodings expect.
+   *
+   * @param runs the number of greedy runs after DSATUR
+   * @param[out] color the color (from 0) of each vertex 1..n, color[0] is unused
+   * @return the number of colors
+   */
+  unsigned int heuristic_coloring(const Graph& g, unsigned int runs, std::vector<unsigned int>& color, unsigned int seed = 1);
+
+}
+
+#endif
@@ -0,0 +1,312 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "Decomposition.h"
+#include "Graph.h"
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace msp {
+
+  static const char triangulation_cache_magic[8] = { 'G', 'C', 'O', 'L', 'T', 'R', 'I', '\0' };
+
+  std::string graph_content_hash(const Graph& g)
+  {
+    uint64_t h1 = 0x9E3779B97F4A7C15ULL ^ g.getNbNodes(), h2 = 0xC2B2AE3D27D4EB4FULL + g.getNbEdges();
+
+    for (unsigned int u = 1; u <= g.getNbNodes(); u++)
+      for (unsigned int v: g.neighbors(u))
+        if (u <= v)
+        {
+          uint64_t key = ((uint64_t)u << 32) | v;
+
+          h1 = (h1 ^ key) * 0xBF58476D1CE4E5B9ULL;
+          h1 ^= h1 >> 31;
+
+          h2 = (h2 + key) * 0x94D049BB133111EBULL;
+          h2 = (h2 << 27) | (h2 >> 37);
+        }
+
+    char hex[33];
+    snprintf(hex, sizeof(hex), "%016llx%016llx", (unsigned long long)h1, (unsigned long long)h2);
+    return hex;
+  }
+
+  static std::string cache_file(const char* dir, const std::string& key)
+  {
+    return std::string(dir) + "/" + key + ".tri";
+  }
+
+  bool load_cached_triangulation(const char* dir, const std::string& key, Graph& g)
+  {
+    std::string filename = cache_file(dir, key);
+    FILE* file = fopen(filename.c_str(), "rb");
+
+    if (file == NULL) return false;
+
+    TriangulationCacheHeader h;
+    bool ok = fread(&h, sizeof(h), 1, file) == 1
+      && !memcmp(h.magic, triangulation_cache_magic, sizeof(h.magic))
+      && h.version == TriangulationCacheHeader::current_version
+      && h.nbVertices == g.getNbNodes() && h.nbEdges == g.getNbEdges() && h.nbOrder == g.getNbNodes();
+
+    std::vector<unsigned int> order;
+    std::vector<uint32_t> triplets;
+
+    // the number of triangles is checked against the file size before anything is allocated
+    if (ok)
+    {
+      long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+      ok = size >= 0 && h.nbTriplets <= (uint64_t) size
+        && (uint64_t) size == sizeof(h) + sizeof(uint32_t) * (h.nbOrder + 3 * h.nbTriplets)
+        && fseek(file, sizeof(h), SEEK_SET) == 0;
+    }
+
+    if (ok)
+    {
+      order.resize(h.nbOrder);
+      triplets.resize(3 * h.nbTriplets);
+      ok = fread(order.data(), sizeof(uint32_t), order.size(), file) == order.size()
+        && fread(triplets.data(), sizeof(uint32_t), triplets.size(), file) == triplets.size();
+    }
+
+    fclose(file);
+
+    // the entry is used as is by the encoding: the order must be a permutation of 1..n
+    // and each triangle made of three distinct vertices
+    unsigned int n = g.getNbNodes();
+
+    if (ok)
+    {
+      std::vector<bool> seen(n + 1, false);
+
+      for (unsigned int v : order)
+      {
+        if (v < 1 || v > n || seen[v]) { ok = false; break; }
+        seen[v] = true;
+      }
+    }
+
+    for (size_t t = 0; ok && t < triplets.size(); t += 3)
+    {
+      uint32_t a = triplets[t], b = triplets[t+1], c = triplets[t+2];
+      ok = a >= 1 && a <= n && b >= 1 && b <= n && c >= 1 && c <= n && a != b && a != c && b != c;
+    }
+
+    if (!ok)
+    {
+      printf("c | Ignoring the invalid cache entry %s\n", filename.c_str());
+      return false;
+    }
+
+    g._nodes.swap(order);
+    g.setOfTriplets.assign(triplets.data(), h.nbTriplets);
+
+    return true;
+  }
+
+  void save_cached_triangulation(const char* dir, const std::string& key, const Graph& g)
+  {
+    std::string filename = cache_file(dir, key);
+    std::string temporary = filename + ".tmp";
+
+    FILE* file = fopen(temporary.c_str(), "wb");
+
+    if (file == NULL)
+    {
+      printf("c | Could not write the cache entry %s\n", filename.c_str());
+      return;
+    }
+
+    TriangulationCacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, triangulation_cache_magic, sizeof(h.magic));
+
+    h.version    = TriangulationCacheHeader::current_version;
+    h.nbVertices = g.getNbNodes();
+    h.nbEdges    = g.getNbEdges();
+    h.nbOrder    = g._nodes.size();
+    h.nbTriplets = g.setOfTriplets.size();
+
+    bool ok = fwrite(&h, sizeof(h), 1, file) == 1;
+    ok = ok && fwrite(g._nodes.data(), sizeof(uint32_t), g._nodes.size(), file) == g._nodes.size();
+    ok = ok && fwrite(g.setOfTriplets.data(), sizeof(Triangle), g.setOfTriplets.size(), file) == g.setOfTriplets.size();
+    ok = (fclose(file) == 0) && ok;
+
+    // the entry only appears once complete, so that concurrent runs never read a partial file
+    if (!ok || rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+      remove(temporary.c_str());
+      printf("c | Could not write the cache entry %s\n", filename.c_str());
+    }
+  }
+
+  void read_td(const char* filename, const Graph& g, std::vector<unsigned int>& order)
+  {
+    std::ifstream in(filename);
+
+    if (!in) fprintf(stderr, "ERROR! Could not open file: %s\n", filename), exit(1);
+
+    unsigned int nbBags = 0, width = 0, nbVertices = 0;
+    std::vector<std::vector<unsigned int>> bags, tree;
+    std::string line;
+    bool header = false;
+
+    while (std::getline(in, line))
+    {
+      std::istringstream tokens(line);
+      std::string first;
+
+      if (!(tokens >> first) || first == "c") continue;
+
+      if (first == "s")
+      {
+        std::string td;
+        if (!(tokens >> td >> nbBags >> width >> nbVertices) || td != "td")
+          fprintf(stderr, "PARSE ERROR! Invalid solution line in %s: %s\n", filename, line.c_str()), exit(3);
+
+        if (nbVertices != g.getNbNodes())
+          fprintf(stderr, "ERROR! The decomposition of %s has %u vertices, the graph has %u\n", filename, nbVertices, g.getNbNodes()), exit(1);
+
+        bags.resize(nbBags+1);
+        tree.resize(nbBags+1);
+        header = true;
+      }
+      else if (!header)
+        fprintf(stderr, "PARSE ERROR! Missing \"s td\" line in %s\n", filename), exit(3);
+      else if (first == "b")
+      {
+        unsigned int bag, v;
+        if (!(tokens >> bag) || bag == 0 || bag > nbBags)
+          fprintf(stderr, "PARSE ERROR! Invalid bag line in %s: %s\n", filename, line.c_str()), exit(3);
+
+        while (tokens >> v)
+        {
+          if (v == 0 || v > nbVertices) fprintf(stderr, "PARSE ERROR! Invalid vertex in %s: %s\n", filename, line.c_str()), exit(3);
+          bags[bag].push_back(v);
+        }
+      }
+      else
+      {
+        unsigned int i = atoi(first.c_str()), j = 0;
+        if (!(tokens >> j) || i == 0 || i > nbBags || j == 0 || j > nbBags)
+          fprintf(stderr, "PARSE ERROR! Invalid tree edge in %s: %s\n", filename, line.c_str()), exit(3);
+
+        tree[i].push_back(j);
+        tree[j].push_back(i);
+      }
+    }
+
+    if (!header) fprintf(stderr, "PARSE ERROR! Missing \"s td\" line in %s\n", filename), exit(3);
+
+    // breadth-first from the roots: the first bag reached containing v is its highest bag
+    std::vector<unsigned int> visit, depth(nbBags+1, 0), top(nbVertices+1, 0);
+    std::vector<char> seen(nbBags+1, false);
+
+    for (unsigned int root = 1; root <= nbBags; root++)
+    {
+      if (seen[root]) continue;
+
+      seen[root] = true;
+      visit.push_back(root);
+
+      for (size_t i = visit.size()-1; i < visit.size(); i++)
+        for (unsigned int b: tree[visit[i]])
+          if (!seen[b]) { seen[b] = true; depth[b] = depth[visit[i]] + 1; visit.push_back(b); }
+    }
+
+    std::vector<unsigned int> rank(nbBags+1, 0);
+    for (unsigned int i = 0; i < visit.size(); i++) rank[visit[i]] = i;
+
+    for (unsigned int b: visit)
+      for (unsigned int v: bags[b])
+        if (top[v] == 0) top[v] = b;
+
+    order.clear();
+    for (unsigned int v = 1; v <= nbVertices; v++)
+    {
+      if (top[v] == 0) fprintf(stderr, "ERROR! Vertex %u is in no bag of %s\n", v, filename), exit(1);
+      order.push_back(v);
+    }
+
+    // the deepest bags first, so that a bag is done after all the bags below it
+    std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return rank[top[a]] > rank[top[b]]; });
+  }
+
+  void write_td(const char* filename, const Graph& g, const std::vector<unsigned int>& order)
+  {
+    unsigned int n = g.getNbNodes();
+
+    std::vector<unsigned int> position(n+1, 0), parent(n+1, 0);
+    std::vector<std::vector<unsigned int>> higher;
+
+    for (unsigned int i = 0; i < order.size(); i++) position[order[i]] = i;
+
+    filled_graph(g, order, higher);
+
+    unsigned int width = 0;
+
+    // the bag of v is attached to the bag of its earliest later neighbor
+    for (unsigned int v: order)
+    {
+      const std::vector<unsigned int>& h = higher[v];
+
+      if (h.size() + 1 > width) width = h.size() + 1;
+
+      if (!h.empty()) parent[v] = *std::min_element(h.begin(), h.end(), [&](unsigned int a, unsigned int b) { return position[a] < position[b]; });
+    }
+
+    FILE* file = fopen(filename, "w");
+
+    if (file == NULL) fprintf(stderr, "ERROR! Could not open file: %s\n", filename), exit(1);
+
+    // bag i is the bag of the i-th eliminated vertex
+    fprintf(file, "s td %u %u %u\n", (unsigned int)order.size(), width, n);
+
+    for (unsigned int i = 0; i < order.size(); i++)
+    {
+      fprintf(file, "b %u %u", i+1, order[i]);
+      for (unsigned int x: higher[order[i]]) fprintf(file, " %u", x);
+      fprintf(file, "\n");
+    }
+
+    // the roots (one per connected component) are chained to make a tree
+    unsigned int previousRoot = 0;
+
+    for (unsigned int i = 0; i < order.size(); i++)
+    {
+      unsigned int v = order[i];
+
+      if (parent[v]) fprintf(file, "%u %u\n", i+1, position[parent[v]]+1);
+      else
+      {
+        if (previousRoot) fprintf(file, "%u %u\n", previousRoot, i+1);
+        previousRoot = i+1;
+      }
+    }
+
+    if (fclose(file) != 0) fprintf(stderr, "ERROR! Could not write file: %s\n", filename), exit(1);
+
+    printf("c | Tree decomposition of width %u written in %s\n", width - 1, filename);
+  }
+
+}
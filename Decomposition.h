@@ -0,0 +1,81 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace msp {
+
+  class Graph;
+
+  /** Returns a 128-bit hash (32 hex digits) of the number of vertices and of the sorted edge set. */
+  std::string graph_content_hash(const Graph& g);
+
+  /** @brief header of the files of the triangulation cache, followed by the order and the triangles */
+  struct TriangulationCacheHeader {
+
+    static const uint32_t current_version = 2;
+
+    char magic[8];
+
+    uint32_t version;
+
+    uint32_t nbVertices;
+
+    uint64_t nbEdges;
+
+    uint64_t nbOrder;
+
+    uint64_t nbTriplets;
+  };
+
+  /**
+   * @brief Loads the elimination order and the triangles cached under the given key in dir.
+   *
+   * @return false if there is no such entry, or if it does not match the graph
+   */
+  bool load_cached_triangulation(const char* dir, const std::string& key, Graph& g);
+
+  /** Stores the elimination order and the triangles of the graph under the given key in dir. */
+  void save_cached_triangulation(const char* dir, const std::string& key, const Graph& g);
+
+  /**
+   * @brief Reads a tree decomposition in the PACE .td format and derives an elimination order from it.
+   *
+   * The vertices are eliminated from the leaves of the decomposition up: a vertex is eliminated
+   * once every bag below the highest bag containing it is done.
+   */
+  void read_td(const char* filename, const Graph& g, std::vector<unsigned int>& order);
+
+  /**
+   * @brief Writes the tree decomposition given by an elimination order in the PACE .td format.
+   *
+   * The bag of v is v and its later neighbors in the filled graph, attached to the bag of the
+   * earliest of them.
+   */
+  void write_td(const char* filename, const Graph& g, const std::vector<unsigned int>& order);
+
+}
+
+#endif
@@ -1,27 +0,0 @@
-/*****************************************************************************************
-* Copyright (c) 2018 Artois University
-*
-* This file is part of CEGAR-RCC8
-*
-* CEGAR-RCC8 is free software: you can redistribute it and/or modify it 
-* under the terms of the GNU General Public License as published by the Free Software Foundation, 
-* either version 3 of the License, or (at your option) any later version.
-*
-* CEGAR-RCC8 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; 
-* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. 
-* See the GNU General Public License for more details.
-*
-* You should have received a copy of the GNU General Public License along with CEGAR-RCC8.
-* If not, see http://www.gnu.org/licenses/.
-*
-* Authors:
-* 		 - Michael Sioutis 	   (michael.sioutis@oru.se)
-* 		 - Jean Marie Lagniez  (lagniez@cril.fr)
-* 		 - Valentin Montmirail (montmirail@cril.fr)
-*
-* Contributors:
-* 		 - Valentin Montmirail (montmirail@cril.fr)
-***************************************************************************************************/
-
-#include "Edge.h"
-
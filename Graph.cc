@@ -19,12 +19,14 @@
 /** This file implements the Graph class, which contains routines for manipulating domain graphs */
 
 #include "Graph.h"
+#include "GraphReader.h"
+#include "BitOps.h"
+#include "LowerBound.h"
+#include "Decomposition.h"
 #include <utility>
 #include <vector>
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <iterator>
 #include <chrono>
 #include <set>
 
@@ -33,73 +35,359 @@ using namespace std;
 namespace msp {
 
 
-  Graph::Graph(bool triangulation) 
+  Graph::Graph(bool triangulation, const char* filename, unsigned int nbThreads, GraphFormat format, const TriangulationOptions& triangulationOptions) : nbVertices(0), nbEdges(0), _pendingSorted(true), nbAnnouncedEdges(0), _triangulation(triangulationOptions)
   {    
     cout << "c | Parsing started                                                                                       |" << endl;
     auto t_start = chrono::high_resolution_clock::now();
-    double elaspedTimeMs;
+    double elaspedTimeMs, initTimeMs;
+    bool parallel = (filename != NULL);
+    unsigned int stored = 0; // what the snapshot contains, if the input is a snapshot
+    ParseTimes times;
 
-    for (string line; getline(cin, line);) 
-    { 
-      if(line[0] == 'c') continue;
-
-      istringstream buf(line);
-        istream_iterator<string> beg(buf), end;
-        vector<string> tokens(beg, end);
+    if(parallel)
+    {
+      MappedFile file(filename);
 
-      if(line[0] == 'p')
+      if(is_graph_snapshot(file.data(), file.size()))
       {
-          nbVertices = stoi(tokens[2]);
-          nbEdges    = stoi(tokens[3]);
+        stored = load_binary(file.data(), file.size(), triangulation ? &triangulationOptions : NULL);
+        parallel = false;
+      }
+      else if(is_gzip(file.data(), file.size()))
+      {
+        gzFile in = gzopen(filename, "rb");
+
+        if(in == NULL) fprintf(stderr, "ERROR! Could not open file: %s\n", filename), exit(1);
 
-          printf("c | *  %8d edges                                                                                     | \n",nbEdges);
-          printf("c | *  %8d nodes                                                                                     | \n",nbVertices); 
+        {
+          GzipStream stream(in);
+          format = detect_graph_format(format, filename, stream.peek(), stream.available());
+          parse_graph(stream, *this, format);
+        }
 
-          nbEdges = 0;
-          variable.resize(nbVertices+1);
+        gzclose(in);
+        parallel = false;
+      }
+      else 
+      {
+        format = detect_graph_format(format, filename, file.data(), file.size());
+
+        if(format == FORMAT_DIMACS) parse_graph_DIMACS_parallel(file.data(), file.size(), *this, nbThreads, times);
+        else
+        {
+          Glucose::MemoryBuffer in(file.data(), file.size());
+          parse_graph(in, *this, format);
+          parallel = false;
+        }
+      }
+    }
+    else
+    {
+      // stdin may be compressed as well, zlib reads plain text as is
+      gzFile in = gzdopen(0, "rb");
 
-          for(unsigned int i = 0; i <= nbVertices; i++)
-          {
-            variable[i] = new Variable(i,std::to_string((i)));
-          }
+      if(in == NULL) fprintf(stderr, "ERROR! Could not read the standard input\n"), exit(1);
 
-      } 
-      else if(line[0] == 'e') 
-      { 
-        add_edge(stoi(tokens[1]), stoi(tokens[2]));
+      {
+        GzipStream stream(in);
+        format = detect_graph_format(format, NULL, stream.peek(), stream.available());
+        parse_graph(stream, *this, format);
       }
+
+      gzclose(in);
+    }
+
+    auto t_read = chrono::high_resolution_clock::now();
+
+    if(_offsets.empty()) 
+    {
+      build();
+      printf("c | *  %8d unique edges (%d announced)                                                            | \n",nbEdges,nbAnnouncedEdges);
     }
  
+    auto t_build = chrono::high_resolution_clock::now();
+    times.build += std::chrono::duration<double, std::milli>(t_build-t_read).count();        
+
     std::vector<Factor > factors;
 
-    toInitialize(factors);    
+    if(!(stored & GraphSnapshotHeader::has_order)) toInitialize(factors);    
 
     auto t_end = chrono::high_resolution_clock::now();
     elaspedTimeMs = std::chrono::duration<double, std::milli>(t_end-t_start).count();        
-    printf("c | Parsing done: %4.5f ms\n",elaspedTimeMs);
+    initTimeMs = std::chrono::duration<double, std::milli>(t_end-t_build).count();        
 
-    if(triangulation)
+    if(parallel)
+      printf("c | Parsing done: %4.5f ms (scan: %4.5f ms, merge: %4.5f ms, build: %4.5f ms, init: %4.5f ms)\n",elaspedTimeMs,times.scan,times.merge,times.build,initTimeMs);
+    else
+      printf("c | Parsing done: %4.5f ms\n",elaspedTimeMs);
+
+    // the elimination orders intersect the rows of the bit-matrix with this kernel
+    if(adjacency.isDense())
+      printf("c | Adjacency bit-matrix: %zu words per row, popcount kernel: %s\n",adjacency.nbWords(),popcount_kernel_name());
+
+    if(triangulation && (stored & GraphSnapshotHeader::has_triplets))
+    {
+      std::cout << "c | Number of Triangles: " << setOfTriplets.size() << " (from the snapshot)" << endl;
+    }
+    else if(triangulation && triangulationOptions.maxLowerBound && improve_lower_bound() > triangulationOptions.maxLowerBound)
+    {
+      printf("c | Triangulation skipped: the treewidth is at least %u (limit: %u)\n",_l_width,triangulationOptions.maxLowerBound);
+      setOfTriplets.clear();
+    }
+    else if(triangulation)
     {
       t_start = chrono::high_resolution_clock::now();
-      triangulate(setOfTriplets);
+
+      const char* source = triangulationOptions.tdInput ? triangulationOptions.tdInput : ordering_name(triangulationOptions.heuristic);
+      bool useCache = triangulationOptions.cacheDir && !triangulationOptions.tdInput;
+      bool cached = false;
+      std::string key;
+
+      if(useCache)
+      {
+        key = graph_content_hash(*this) + "-" + source + (triangulationOptions.minimizeClique ? "-clique" : "");
+        cached = load_cached_triangulation(triangulationOptions.cacheDir, key, *this);
+      }
+
+      if(!cached) triangulate(setOfTriplets, triangulationOptions);
+      if(useCache && !cached) save_cached_triangulation(triangulationOptions.cacheDir, key, *this);
+
       t_end = chrono::high_resolution_clock::now();
-      std::cout << "c | Number of Triangles: " << setOfTriplets.size() << endl;
-      printf("c | Triangulation done: %4.5f ms\n",elaspedTimeMs);
+      elaspedTimeMs = std::chrono::duration<double, std::milli>(t_end-t_start).count();        
+      std::cout << "c | Number of Triangles: " << setOfTriplets.size() << (cached ? " (from the cache)" : "") << endl;
+      printf("c | Triangulation done: %4.5f ms (%s)\n",elaspedTimeMs,source);
     }
+    else setOfTriplets.clear();
 
     // cout << *this << endl;
 
   }
 
-  bool Graph::are_nodes_connected(unsigned int i, unsigned int j)
+  void Graph::setDimensions(unsigned int nbV, unsigned int nbE)
+  {
+    nbVertices = nbV;
+    nbEdges    = nbE;
+
+    printf("c | *  %8d edges                                                                                     | \n",nbEdges);
+    printf("c | *  %8d nodes                                                                                     | \n",nbVertices); 
+
+    nbAnnouncedEdges = nbE;
+    nbEdges = 0;
+    _pending.reserve(nbE);
+  }
+
+  void Graph::add_unique_edges(std::vector<uint64_t>& keys)
+  {
+    if (_pending.empty()) _pending.swap(keys);
+    else
+    {
+      _pending.insert(_pending.end(), keys.begin(), keys.end());
+      _pendingSorted = false;
+    }
+
+    std::vector<uint64_t>().swap(keys);
+  }
+
+  void Graph::build()
+  {
+    if (!_pendingSorted) radix_sort_unique(_pending);
+
+    nbEdges = _pending.size();
+    _pendingSorted = true;
+
+    // vertex ids go from 0 to nbVertices (0 is never used by the DIMACS format)
+    _offsets.assign(nbVertices+2, 0);
+
+    for (uint64_t key : _pending)
+    {
+      unsigned int i = key >> 32, j = key & 0xFFFFFFFF;
+      _offsets[i+1]++;
+      if (i != j) _offsets[j+1]++;
+    }
+
+    for (unsigned int v = 0; v <= nbVertices; v++) _offsets[v+1] += _offsets[v];
+
+    _adj.resize(_offsets[nbVertices+1]);
+
+    std::vector<uint64_t> fill(_offsets.begin(), _offsets.end()-1);
+
+    // the keys are sorted by (min,max), so each row receives its smaller neighbors in increasing
+    // order and then its larger neighbors in increasing order: the rows come out sorted
+    for (uint64_t key : _pending)
+    {
+      unsigned int i = key >> 32, j = key & 0xFFFFFFFF;
+      _adj[fill[i]++] = j;
+      if (i != j) _adj[fill[j]++] = i;
+    }
+
+    std::vector<uint64_t>().swap(_pending);
+
+    _p.assign(nbVertices+1, false);
+
+    adjacency.init(nbVertices, nbEdges);
+
+    if (adjacency.isDense())
+      for (unsigned int u = 0; u <= nbVertices; u++)
+        for (unsigned int v: neighbors(u))
+          if (u <= v) adjacency.insert(u,v);
+  }
+
+  /** Exits if the snapshot is inconsistent, the message tells what is wrong. */
+  static void check_snapshot(bool ok, const char* what)
   {
-    for(Edge* e : edges)
+    if(!ok) fprintf(stderr, "ERROR! Corrupted graph snapshot: %s\n", what), exit(1);
+  }
+
+  unsigned int Graph::load_binary(const char* data, size_t size, const TriangulationOptions* options)
+  {
+    GraphSnapshotHeader h;
+    memcpy(&h, data, sizeof(h));
+
+    if(h.version != GraphSnapshotHeader::current_version) 
+      fprintf(stderr, "ERROR! Unsupported graph snapshot version: %u (expected %u)\n", h.version, GraphSnapshotHeader::current_version), exit(1);
+
+    // the counts are compared to the size before being multiplied, so that the sum cannot wrap around
+    size_t words = (size - sizeof(h)) / sizeof(uint32_t);
+    uint64_t nbOrder    = (h.flags & GraphSnapshotHeader::has_order) ? h.nbOrder : 0;
+    uint64_t nbTriplets = (h.flags & GraphSnapshotHeader::has_triplets) ? h.nbTriplets : 0;
+
+    bool fits = h.nbAdj <= words && nbOrder <= words && nbTriplets <= words
+      && 2 * ((uint64_t) h.nbVertices + 2) + h.nbAdj + nbOrder + 3 * nbTriplets <= words;
+
+    if(!fits) fprintf(stderr, "ERROR! Truncated graph snapshot\n"), exit(1);
+
+    setDimensions(h.nbVertices, h.nbEdges);
+
+    const char* p = data + sizeof(h);
+
+    _offsets.resize(nbVertices + 2);
+    memcpy(&_offsets[0], p, _offsets.size() * sizeof(uint64_t));
+    p += _offsets.size() * sizeof(uint64_t);
+
+    check_snapshot(_offsets[0] == 0 && _offsets[nbVertices+1] == h.nbAdj, "the offsets do not cover the neighbors");
+    for (unsigned int v = 0; v <= nbVertices; v++) check_snapshot(_offsets[v] <= _offsets[v+1], "decreasing offsets");
+
+    _adj.resize(h.nbAdj);
+    if(h.nbAdj) memcpy(&_adj[0], p, h.nbAdj * sizeof(uint32_t));
+    p += h.nbAdj * sizeof(uint32_t);
+
+    // the rows are sorted (are_nodes_connected searches them) and only hold ids 1..nbVertices
+    for (unsigned int v = 0; v <= nbVertices; v++)
+      for (uint64_t i = _offsets[v]; i < _offsets[v+1]; i++)
+        check_snapshot(_adj[i] >= 1 && _adj[i] <= nbVertices && (i == _offsets[v] || _adj[i-1] < _adj[i]), "invalid neighbor");
+
+    nbEdges = h.nbEdges;
+    _p.assign(nbVertices+1, false);
+
+    adjacency.init(nbVertices, nbEdges);
+
+    if(adjacency.isDense())
+      for (unsigned int u = 0; u <= nbVertices; u++)
+        for (unsigned int v: neighbors(u))
+          if (u <= v) adjacency.insert(u,v);
+
+    if(h.flags & GraphSnapshotHeader::has_order)
+    {
+      check_snapshot(h.nbOrder == nbVertices, "the order does not have one entry per vertex");
+
+      _nodes.resize(h.nbOrder);
+      if(h.nbOrder) memcpy(&_nodes[0], p, h.nbOrder * sizeof(uint32_t));
+      p += h.nbOrder * sizeof(uint32_t);
+
+      // a permutation of 1..nbVertices, _p is reset afterwards
+      for (unsigned int v: _nodes)
+      {
+        check_snapshot(v >= 1 && v <= nbVertices && !_p[v], "the order is not a permutation of the vertices");
+        _p[v] = true;
+      }
+
+      _p.assign(nbVertices+1, false);
+
+      _l_width  = h.l_width;
+      _u_width  = h.u_width;
+      _l_wwidth = h.l_wwidth;
+      _u_wwidth = h.u_wwidth;
+    }
+
+    if(h.flags & GraphSnapshotHeader::has_triplets)
     {
-      if( (e->getIn() == i && e->getOut() == j) || (e->getIn() == j && e->getOut() == i)) 
-        return true;
+      std::vector<uint32_t> triplets(3 * h.nbTriplets);
+      memcpy(triplets.data(), p, triplets.size() * sizeof(uint32_t));
+
+      for (uint32_t v: triplets) check_snapshot(v >= 1 && v <= nbVertices, "invalid vertex in a triangle");
+
+      // a .td file may have changed since the snapshot, its triangles are never reused
+      bool same = options && !options->tdInput && h.heuristic == (uint32_t) options->heuristic
+        && ((h.flags & GraphSnapshotHeader::min_clique) != 0) == options->minimizeClique;
+
+      if(same) setOfTriplets.assign(triplets.data(), h.nbTriplets);
+      else
+      {
+        if(options) printf("c | Triangles of the snapshot dropped: they were not computed with %s\n", options->tdInput ? options->tdInput : ordering_name(options->heuristic));
+        h.flags &= ~GraphSnapshotHeader::has_triplets;
+      }
     }
 
-    return false;
+    return h.flags;
+  }
+
+  void Graph::save_binary(const char* filename)
+  {
+    FILE* file = fopen(filename, "wb");
+
+    if(file == NULL) fprintf(stderr, "ERROR! Could not open file: %s\n", filename), exit(1);
+
+    GraphSnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, graph_snapshot_magic, sizeof(h.magic));
+
+    h.version    = GraphSnapshotHeader::current_version;
+    h.flags      = 0;
+    h.nbVertices = nbVertices;
+    h.nbEdges    = nbEdges;
+    h.nbAdj      = _adj.size();
+    h.l_width    = _l_width;
+    h.u_width    = _u_width;
+    h.l_wwidth   = _l_wwidth;
+    h.u_wwidth   = _u_wwidth;
+    h.nbOrder    = _nodes.size();
+    h.nbTriplets = setOfTriplets.size();
+
+    h.heuristic  = _triangulation.tdInput ? GraphSnapshotHeader::from_td_file : (uint32_t) _triangulation.heuristic;
+
+    // toInitialize() or the triangulation give an order of all the vertices, anything else is not written
+    if(_nodes.size() == nbVertices) h.flags |= GraphSnapshotHeader::has_order;
+    else h.nbOrder = 0;
+
+    if(!setOfTriplets.empty()) h.flags |= GraphSnapshotHeader::has_triplets;
+    if(_triangulation.minimizeClique) h.flags |= GraphSnapshotHeader::min_clique;
+
+    bool ok = fwrite(&h, sizeof(h), 1, file) == 1;
+    ok = ok && fwrite(&_offsets[0], sizeof(uint64_t), _offsets.size(), file) == _offsets.size();
+    ok = ok && fwrite(_adj.data(), sizeof(uint32_t), _adj.size(), file) == _adj.size();
+    ok = ok && fwrite(_nodes.data(), sizeof(uint32_t), h.nbOrder, file) == h.nbOrder;
+
+    ok = ok && fwrite(setOfTriplets.data(), sizeof(Triangle), setOfTriplets.size(), file) == setOfTriplets.size();
+
+    if(fclose(file) != 0 || !ok) fprintf(stderr, "ERROR! Could not write file: %s\n", filename), exit(1);
+
+    printf("c | Graph snapshot written in %s\n", filename);
+  }
+
+  unsigned int Graph::improve_lower_bound()
+  {
+    auto t_start = chrono::high_resolution_clock::now();
+
+    unsigned int degeneracy = _l_width;
+    unsigned int minD   = contraction_lower_bound(*this, CONTRACT_MIN_D);
+    unsigned int leastC = contraction_lower_bound(*this, CONTRACT_LEAST_C);
+
+    _l_width = std::max(degeneracy, std::max(minD, leastC));
+
+    double elaspedTimeMs = std::chrono::duration<double, std::milli>(chrono::high_resolution_clock::now()-t_start).count();
+    printf("c | Treewidth lower bound: %u (degeneracy: %u, min-d: %u, least-c: %u) in %4.5f ms\n",_l_width,degeneracy,minD,leastC,elaspedTimeMs);
+
+    return _l_width;
   }
 
   /** Constructor for given list of factors */
@@ -108,45 +396,39 @@ namespace msp {
     _l_width =  0;
     _l_wwidth = 0;
 
-    _nodes.resize(_g.size());
+    _nodes.resize(nbVertices);
 
     unsigned card=0;
     
     // unmark all nodes and find highest size of variable
-    for (auto v: _g) {
+    for (unsigned int v = 1; v <= nbVertices; v++) {
 
-	     _p[v.first] = false;
-    	 if (v.first->size() > card) card = v.first->size();
+	     _p[v] = false;
+    	 if (cardinality(v) > card) card = cardinality(v);
     }
 
-    _u_width  = _g.size(); // trivial upper bound on treewidth
+    _u_width  = nbVertices; // trivial upper bound on treewidth
 
     _u_wwidth = (_u_width+1)*log2(card); // trivial upper bound on weighted treewidth
 
-    // // run min-degree heuristic to find lower bound on treewidth
-    std::pair<Variable*, unsigned> r;
-
-    for (unsigned i=0; i < _nodes.size(); i++) {
-
-     	// select variable
-    	r = min_degree();
+    // // run min-degree heuristic (without fill, i.e. the degeneracy) to find lower bound on treewidth
+    degeneracy_order(*this, _nodes);
 
-    	// add it to order
-    	_nodes[i] = r.first;
+    for (unsigned int v: _nodes) {
 
      	// mark variable
-    	_p[r.first] = true;
+    	_p[v] = true;
 
      	// for detecting maximum variable cardinality
-    	if (r.first->size() > card) card = r.first->size();
+    	if (cardinality(v) > card) card = cardinality(v);
 
-    	double degree = 0; double weight = log2(r.first->size());
+    	double degree = 0; double weight = log2(cardinality(v));
     	// comput weigth
-    	for (auto x: _g[r.first])
+    	for (unsigned int x: neighbors(v))
         
         if (!_p[x]) {
     		  degree++; // node's degree in chordalization
-    		  weight += log2(x->size()); // node's weight in cordalization
+    		  weight += log2(cardinality(x)); // node's weight in cordalization
     	  }
 
     	  if (degree>_l_width) _l_width=degree; // update lower bound on treewidth
@@ -157,101 +439,29 @@ namespace msp {
   }
 
   /** Constructor for given vector of variable cliques */
-  Graph::Graph( std::vector<std::vector<Variable* > >& cliques ) : _l_width(0), _l_wwidth(0) // trivial lower bounds on treewidth
+  Graph::Graph( std::vector<std::vector<Variable* > >& cliques ) : nbVertices(0), nbEdges(0), _pendingSorted(true), nbAnnouncedEdges(0)
   {
-    // turn factor scopes into cliques
     for (auto clique: cliques)
       for (auto u: clique)
-	for (auto v: clique)
-	  if (u != v) _g[u].insert(v);
+        if (u->id() > nbVertices) nbVertices = u->id();
 
-    _nodes.resize(_g.size());
+    // ids which do not appear in any clique are dimensionless
+    _card.assign(nbVertices+1, 1);
 
-    unsigned card=0;
-    // unmark all nodes and find highest size of variable
-    for (auto v: _g)
+    // turn factor scopes into cliques
+    for (auto clique: cliques)
+      for (auto u: clique)
       {
-	_p[v.first] = false;
-    	if (v.first->size() > card) card = v.first->size();
+        _card[u->id()] = u->size();
+	for (auto v: clique)
+	  if (u->id() < v->id()) add_edge(u->id(), v->id());
       }
-    _u_width  = _g.size(); // trivial upper bound on treewidth
-    _u_wwidth = (_u_width+1)*log2(card); // trivial upper bound on weighted treewidth
-
-    // // run min-degree heuristic to find lower bound on treewidth
-    std::pair<Variable*, unsigned> r;
-    for (unsigned i=0; i < _nodes.size(); i++)
-      {
-     	// select variable
-    	r = min_degree();
-    	// add it to order
-    	_nodes[i] = r.first;
-     	// mark variable
-    	_p[r.first] = true;
-     	// for detecting maximum variable cardinality
-    	if (r.first->size() > card) card = r.first->size();
 
-    	double degree = 0; double weight = log2(r.first->size());
-    	// comput weigth
-    	  for (auto x: _g[r.first])
-    	    if (!_p[x])
-    	      {
-    		degree++; // node's degree in chordalization
-    		weight += log2(x->size()); // node's weight in cordalization
-    	      }
-    	  if (degree>_l_width) _l_width=degree; // update lower bound on treewidth
-    	  if (weight>_l_wwidth) _l_wwidth=weight; // update lower bound on weighted treewidth
-    }
-  }
+    build();
 
-  /** Min fill heuristic.
-   *
-   * Chooses node with least number of unconnected neighbors and returns a pair (node, degree*), where degree* is the number of higher-ordered neighbors.
-   *
-   */
-  std::pair<Variable*, unsigned> Graph::min_fill()
-  {
-    
-    std::pair<Variable* , unsigned> res(0, _g.size());
-    for (auto var: _p)
-      if (!var.second)
-	{ 
-	  unsigned this_score = 0; // score for this variable
-	  // count the number of fill-in edges for each variable
-	  for (auto x: _g[var.first])
-	    if (!_p[x])
-	      for (auto y: _g[var.first])
-		if (*x < *y && !_p[y] && !_g[x].count(y)) // y is not a adjacent to x -- fill-in edge found!
-		      this_score++;
-	  if (this_score < res.second)
-	    { // update incubent solution
-	      res.second = this_score; res.first=var.first;
-	    }
-	}
-    return res;
-  }
+    std::vector<Factor > factors;
 
-  /** Min degree heuristic.
-   *
-   * Chooses node with least number of unconnected neighbors, and  returns a pair (node, degree*), where degree* is the number of higher-ordered neighbors.
-   *
-   */
-  std::pair<Variable*, unsigned> Graph::min_degree()
-  {
-    
-    std::pair<Variable* , unsigned> res(NULL, _g.size());
-    for (auto var: _p)
-      if (!var.second)
-	{ 
-	  unsigned this_score = 0; // score for this variable
-	  for (auto x: _g[var.first])
-	    if (!_p[x]) 	  // count the number of higher-order neighbors
-	      this_score++;
-	  if (this_score < res.second)
-	    { // update incubent solution
-	      res.second = this_score; res.first=var.first;
-	    }
-	}
-    return res;
+    toInitialize(factors);
   }
 
   /** Triangulates the graph and finds a suitable variable elimination sequence.
@@ -260,121 +470,56 @@ namespace msp {
    *  finds a perfect elimination sequence for the resulting chordal graph.
    *
    */
-  void Graph::triangulate(std::vector<std::vector<unsigned int>> & setOfTriplets)
+  void Graph::triangulate(TriangleSet& setOfTriplets, const TriangulationOptions& options)
   {
-    std::pair<Variable*, unsigned> r;
+    std::vector<std::vector<unsigned int>> later;
 
-    // unmark all nodes
-    for (auto v: _p) _p[v.first] = false;
+    if (options.tdInput) read_td(options.tdInput, *this, _nodes);
+    else elimination_order(*this, options, _nodes);
 
-    unsigned int i = 0, degree = 0;
+    // the later neighbors include the fill edges, so that the triangles cover the chordal completion
+    filled_graph(*this, _nodes, later);
 
-    while (i <= _nodes.size()+1)
+    for (unsigned int u: _nodes)
     {
-      // select variable to eliminate
-      r = min_fill();
+      const std::vector<unsigned int>& remaining = later[u];
 
-      // add it to order
-      _nodes[i++] = r.first;
-
-      // mark variable
-      _p[r.first] = true;
-
-      degree = 0; 
-        
-      // connect neighbors
-      for (auto x: _g[r.first])
-      {
-      	if (!_p[x])
-        {
-          degree++; // node's degree in chordalization            
-            	
-          for (auto y: _g[r.first])
-          {              
-            if (x != NULL && y != NULL && !_p[y])
-            { 
-              unsigned int i = r.first->id();
-              unsigned int j = x->id();
-              unsigned int k = y->id();              
-
-              if( i != j && j != k && i != k)
-              {
-                std::vector<unsigned int> triplet;              
-                triplet.push_back(i);
-                triplet.push_back(j);
-                triplet.push_back(k);
-                sort(triplet.begin(),triplet.end());
-                
-                bool toAdd = true;
-
-                for(auto t : setOfTriplets)
-                {
-                  if(t == triplet) 
-                  {
-                    toAdd = false;
-                    break;
-                  }
-                }
-
-                if(toAdd)
-                { 
-                  // cout << "c | ";
-                  // for (auto t: triplet) cout << t << " - ";
-                  // cout << endl;
-                  setOfTriplets.push_back(triplet);
-                }
-              }
-            }
-          }
-      	}   
-      }   	 
-    }   
-
-    // exit(0);
+      for (unsigned int a = 0; a < remaining.size(); a++)
+        for (unsigned int b = a+1; b < remaining.size(); b++)
+          setOfTriplets.insert(u, remaining[a], remaining[b]);
+    }
   }
 
   /** Returns a simplicial node.
    *
-   * @return a pointer to a simplicial node or a NULL if no simplicial exists.
+   * @return a simplicial node or 0 if no simplicial exists.
    */
-  Variable* Graph::find_simplicial()
+  unsigned int Graph::find_simplicial()
   {
-    for (auto v: _nodes)
+    for (unsigned int v: _nodes)
       {
 	bool simplicial = true;
-	for (auto x: _g[v])
+	for (unsigned int x: neighbors(v))
 	  if (!_p[x])
-	    for (auto y: _g[v])
-	      if (*x < *y && !_p[y] && !_g[x].count(y))
+	    for (unsigned int y: neighbors(v))
+	      if (x < y && !_p[y] && !are_nodes_connected(x,y))
 		{
 		  simplicial = false; break;
 		}
 	if (simplicial) return v;
       }
-    return NULL;
-  }
-
-
-  /** Returns an ordered vector of Variables 
-   *
-   * @return a vector of variable objects ordered accordingly
-   */
-  std::vector<Variable > Graph::ordering()
-  {
-    std::vector<Variable > order(_nodes.size());
-    for (unsigned i=0; i < _nodes.size(); i++)
-      order[i] = *(_nodes[i]);
-    return order;
+    return 0;
   }
 
   /** Auxiliar function for printing out the edges. */
   std::ostream& Graph::print_edges( std::ostream &o )
   {
-    for (auto u: _g)
+    for (unsigned int u = 1; u <= nbVertices; u++)
       {	
-	o << "c | " << (_p[u.first]?"*":" ") << u.first->name() << ": ";
-	for (Variable* v: _g[u.first])
-	  o << v->name() << " ";
+	if (degree(u) == 0) continue;
+	o << "c | " << (_p[u]?"*":" ") << name(u) << ": ";
+	for (unsigned int v: neighbors(u))
+	  o << name(v) << " ";
 	o << "," << std::endl;
       }
     return o;
@@ -389,12 +534,19 @@ namespace msp {
   {
     fprintf(file,"graph g {\n");
 
-    for(Edge* e : edges)  e->toDOT(file); 
+    toDOT_edges(file);
 
     fprintf(file,"}");
 
   }
 
+  void Graph::toDOT_edges(FILE* file)
+  {
+    for (unsigned int u = 1; u <= nbVertices; u++)
+      for (unsigned int v: neighbors(u))
+        if (u <= v) fprintf(file,"%d -- %d [label=\"\"];\n",u,v);
+  }
+
   /** Default printing. */
   std::ostream& operator<<(std::ostream &o, Graph &g) 
   {
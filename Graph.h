@@ -27,7 +27,12 @@
 #include <vector>
 #include <unordered_set>
 #include <cmath>
-#include "Edge.h"
+#include <algorithm>
+#include <stdint.h>
+#include "AdjacencyIndex.h"
+#include "TriangleSet.h"
+#include "Ordering.h"
+#include "GraphReader.h"
 
 using namespace std;
 
@@ -43,12 +48,23 @@ namespace msp {
   {
 
   public:
+
+    /** @brief a contiguous range of vertex ids, e.g. the neighbors of a vertex */
+    struct NodeRange {
+      const unsigned int* b;
+      const unsigned int* e;
+      inline const unsigned int* begin() const { return b; }
+      inline const unsigned int* end() const { return e; }
+      inline size_t size() const { return e - b; }
+    };
     
-    std::unordered_map<Variable*, std::unordered_set<Variable* > > _g; /*< map from nodes to adjancency sets */
+    std::vector<uint64_t> _offsets; /*< CSR offsets: the neighbors of v are _adj[_offsets[v] .. _offsets[v+1]) */
+
+    std::vector<unsigned int> _adj; /*< CSR neighbors, sorted by id within each vertex */
 
-    std::unordered_map<Variable*, bool> _p; /*< node flag (used for marking processed nodes internally) */
+    std::vector<char> _p; /*< node flag (used for marking processed nodes internally) */
 
-    std::vector<Variable* > _nodes; /*< node ordering */
+    std::vector<unsigned int> _nodes; /*< node ordering */
 
     unsigned _u_width, _l_width; /*< treewidth estimates */
 
@@ -59,38 +75,96 @@ namespace msp {
 
     unsigned int nbEdges;
 
-    /** @brief the set of Edge in the problem */
-    vector<Edge*> edges;    
+    /** @brief the cardinality of each vertex, only stored for graphs built from variable cliques */
+    std::vector<unsigned int> _card;
+
+    TriangleSet setOfTriplets;
+
+    /** @brief constant-time adjacency queries for small or dense graphs */
+    AdjacencyIndex adjacency;
+
+  private:
+
+    /** @brief the edges as packed (min,max) keys, until the CSR is built */
+    std::vector<uint64_t> _pending;
+
+    /** @brief true if _pending is known to be sorted and without duplicates */
+    bool _pendingSorted;
+
+    /** @brief the number of edges announced by the header */
+    unsigned int nbAnnouncedEdges;
+
+    /** @brief the options setOfTriplets was computed with, written in the snapshots */
+    TriangulationOptions _triangulation;
 
-    vector<Variable*> variable;
+    /** Sorts and deduplicates the pending edges, then builds the CSR adjacency from them. */
+    void build();
 
-    vector<vector<unsigned int>> setOfTriplets;
+    /** Loads a binary snapshot, returns the flags telling what it contains (see GraphSnapshotHeader).
+     *
+     * Every offset and vertex id is checked against the size of the data and the number of vertices.
+     * The triangles are dropped (and has_triplets cleared) unless they were computed as options asks,
+     * options is NULL when the graph is not triangulated.
+     */
+    unsigned int load_binary(const char* data, size_t size, const TriangulationOptions* options);
     
   public:
 
-    Graph(bool triangulation = false);
+    /** Class constructor.
+     *
+     * Reads the graph from the given file (memory-mapped, DIMACS files are parsed by nbThreads threads,
+     * 0 meaning one per core), or from stdin if no file is given. Gzip-compressed input is decompressed on the fly.
+     * The format (DIMACS, METIS, edge list or Matrix Market) is detected unless it is given.
+     * If triangulation is true, the elimination order and the triangles are computed as given by the options.
+     */
+    Graph(bool triangulation = false, const char* filename = NULL, unsigned int nbThreads = 0, GraphFormat format = FORMAT_AUTO, const TriangulationOptions& triangulationOptions = TriangulationOptions());
 
     ~Graph() { }
 
-    unsigned int getNbNodes() { return nbVertices; }
+    /** Writes the graph (and its elimination order, bounds and triangles when known) in the binary snapshot format.
+     *
+     * The snapshot can be given as input file instead of the DIMACS file, it is then loaded without any parsing.
+     */
+    void save_binary(const char* filename);
+
+    /** Declares the number of vertices and the number of edges announced by the problem line. */
+    void setDimensions(unsigned int nbV, unsigned int nbE);
 
-    unsigned int getNbEdges() { return nbEdges; }
+    unsigned int getNbNodes() const { return nbVertices; }
 
-    bool are_nodes_connected(unsigned int i, unsigned int j);
+    unsigned int getNbEdges() const { return nbEdges; }
 
+    /** Returns the (sorted) neighbors of v. */
+    inline NodeRange neighbors(unsigned int v) const { NodeRange r = { &_adj[0] + _offsets[v], &_adj[0] + _offsets[v+1] }; return r; }
+
+    inline unsigned int degree(unsigned int v) const { return _offsets[v+1] - _offsets[v]; }
+
+    /** Returns the cardinality of v (vertices read from a file have their id as cardinality). */
+    inline unsigned int cardinality(unsigned int v) const { return _card.empty() ? v : _card[v]; }
+
+    /** Returns the name of v, only computed for printing. */
+    inline std::string name(unsigned int v) const { return std::to_string(v); }
+
+    inline bool are_nodes_connected(unsigned int i, unsigned int j) const 
+    { 
+      if(adjacency.isDense()) return adjacency.contains(i,j); 
+      if(_offsets.empty()) return false;
+
+      NodeRange r = neighbors(i);
+      return std::binary_search(r.begin(), r.end(), j);
+    }
+
+    /** Adds an edge i -- j, the duplicates are removed in bulk when the adjacency is built. */
     void add_edge(unsigned int i, unsigned int j)
     {
         if(i > j) swap(i,j);
 
-        if(!are_nodes_connected(i,j))
-        {
-            edges.push_back(new Edge(i,j));
-            _g[variable[i]].insert(variable[j]); 
-            _g[variable[j]].insert(variable[i]); 
-            nbEdges++;
-        }
+        _pending.push_back(((uint64_t)i << 32) | j);
+        _pendingSorted = false;
     }
 
+    /** Adds edges given as sorted packed (min,max) keys without duplicates, the vector is consumed. */
+    void add_unique_edges(std::vector<uint64_t>& keys);
 
     /** Class constructor.
      *
@@ -113,6 +187,9 @@ namespace msp {
      */
     std::pair<unsigned, unsigned> treewidth() { return std::make_pair(_l_width, _u_width); }
 
+    /** Raises the lower bound on the treewidth with the contraction bounds (see LowerBound.h) and returns it. */
+    unsigned int improve_lower_bound();
+
     /** Return weighted treewidth estimates for the graph.
      *
      * Return lower and upper bounds on the weighted treewidth of the graph. The weighted treewidth is the log_2 of the product of the variable cardinalities in the largest clique of an optimal chordalization of the graph. The graph is intializied with trivial bounds which are updated by call to other methods (e.g., find_order).
@@ -122,41 +199,29 @@ namespace msp {
     std::pair<double, double> w_treewidth() { return std::make_pair(_l_wwidth, _u_wwidth); }
 
 
-    /** Min fill heuristic.
-     *
-     * Returns the next node and its score in ordering according to the min fill heuristic.
-     * @return a pair containing the best node as first element and its score as second element
-     */
-    std::pair<Variable*, unsigned> min_fill();
-
-    /** Min degree heuristic.
-     *
-     * Returns the next node and its score in ordering according to the min fill heuristic.
-     * @return a pair containing the best node as first element and its score as second element
-     */
-    std::pair<Variable*, unsigned> min_degree();
-
-
     /** Triangulates the graph and find a suitable variable elimination sequence.
      *
      *  Uses a heuristic to triangulate the graph (i.e., make it chordal) and then
      *  finds a perfect elimination sequence for the resulting chordal graph.
+     *  The order is computed by the heuristic (or the portfolio) of the options (see Ordering.h), or read from
+     *  a PACE tree decomposition, the triangles are
+     *  each vertex with two of its neighbors eliminated after it in the filled graph (see filled_graph).
      *
      */
-    void triangulate(std::vector<std::vector<unsigned int>> & setOfTriplets);
+    void triangulate(TriangleSet& setOfTriplets, const TriangulationOptions& options = TriangulationOptions());
 
     /** Returns a simplicial node.
      *
-     * @return a pointer to a simplicial node or a NULL if no simplicial exists.
+     * @return a simplicial node or 0 if no simplicial exists.
      */
-    Variable* find_simplicial();
+    unsigned int find_simplicial();
 
 
-    /** Returns an ordered vector of Variables.
+    /** Returns the elimination order.
      *
-     * @return a vector of variable objects ordered accordingly
+     * @return the vertex ids ordered accordingly
      */
-    std::vector<Variable > ordering();
+    const std::vector<unsigned int>& ordering() const { return _nodes; }
 
     /**
     * @brief this methods displays the whole problem in the DOT format.
@@ -165,6 +230,9 @@ namespace msp {
     */
     void toDOT(FILE* file=stdout);
 
+    /** Displays only the edges in the DOT format (one "u -- v" line per edge). */
+    void toDOT_edges(FILE* file=stdout);
+
     /** output factor content info. */
     std::ostream& print_edges( std::ostream &o );
 
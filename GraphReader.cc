@@ -0,0 +1,509 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "GraphReader.h"
+#include "Graph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <ctype.h>
+#include <queue>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace msp {
+
+  void radix_sort_unique(std::vector<uint64_t>& keys)
+  {
+    if (keys.size() < 256)
+    {
+      std::sort(keys.begin(), keys.end());
+    }
+    else
+    {
+      std::vector<uint64_t> buffer(keys.size());
+      std::vector<size_t> count(1 << 16);
+
+      for (unsigned int shift = 0; shift < 64; shift += 16)
+      {
+        std::fill(count.begin(), count.end(), 0);
+
+        for (uint64_t key : keys) count[(key >> shift) & 0xFFFF]++;
+
+        // every key has the same digit, the pass would not move anything
+        if (count[(keys[0] >> shift) & 0xFFFF] == keys.size()) continue;
+
+        size_t sum = 0;
+        for (size_t& c : count) { size_t t = c; c = sum; sum += t; }
+
+        for (uint64_t key : keys) buffer[count[(key >> shift) & 0xFFFF]++] = key;
+
+        keys.swap(buffer);
+      }
+    }
+
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  }
+
+  GraphFormat graph_format_from_name(const char* name)
+  {
+    if (!strcmp(name, "auto"))     return FORMAT_AUTO;
+    if (!strcmp(name, "dimacs"))   return FORMAT_DIMACS;
+    if (!strcmp(name, "metis"))    return FORMAT_METIS;
+    if (!strcmp(name, "edgelist")) return FORMAT_EDGELIST;
+    if (!strcmp(name, "mtx"))      return FORMAT_MTX;
+
+    fprintf(stderr, "ERROR! Unknown graph format: %s (auto, dimacs, metis, edgelist or mtx)\n", name), exit(1);
+  }
+
+  const char* graph_format_name(GraphFormat format)
+  {
+    switch (format)
+    {
+      case FORMAT_DIMACS:   return "dimacs";
+      case FORMAT_METIS:    return "metis";
+      case FORMAT_EDGELIST: return "edgelist";
+      case FORMAT_MTX:      return "mtx";
+      default:              return "auto";
+    }
+  }
+
+  /** Returns true if name ends with suffix. */
+  static bool endsWith(const std::string& name, const char* suffix)
+  {
+    size_t len = strlen(suffix);
+    return name.size() >= len && !name.compare(name.size() - len, len, suffix);
+  }
+
+  /** Reads the next token of the line at p, returns false at the end of the line (p is then on the '\n'). */
+  static bool next_number(const char*& p, const char* end, uint64_t& value, bool& numeric)
+  {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+
+    if (p == end || *p == '\n') return false;
+
+    for (value = 0; p < end && !isspace((unsigned char)*p); p++)
+    {
+      if (*p < '0' || *p > '9') numeric = false;
+      else if (value < (1ULL << 40)) value = value * 10 + (*p - '0');
+    }
+
+    return true;
+  }
+
+  /** @brief what the content says of a METIS header followed by vertex lines */
+  enum MetisCheck {
+    NOT_METIS,     /*< the lines contradict the header */
+    PARTIAL_METIS, /*< fewer lines or neighbors than announced: truncated, or only the first block of a stream */
+    FULL_METIS     /*< exactly N vertex lines whose neighbors add up to 2M */
+  };
+
+  /**
+   * Checks the lines at p as a METIS graph: a header "N M [fmt [ncon]]" then N vertex lines (comments aside)
+   * whose neighbors are in 1..N and add up to 2M.
+   */
+  static MetisCheck check_metis(const char* p, const char* end)
+  {
+    uint64_t header[4], x;
+    unsigned int h = 0;
+    bool numeric = true;
+
+    while (next_number(p, end, x, numeric))
+    {
+      if (h == 4) return NOT_METIS;
+      header[h++] = x;
+    }
+
+    if (h < 2 || !numeric) return NOT_METIS;
+
+    uint64_t n = header[0], m = header[1], fmt = h > 2 ? header[2] : 0, ncon = h > 3 ? header[3] : 1;
+
+    // the neighbors follow the vertex size and weights, each one is followed by its weight if any
+    uint64_t skip = (fmt / 100) % 10 + ((fmt / 10) % 10) * ncon, step = 1 + fmt % 10;
+    uint64_t lines = 0, ends = 0;
+
+    if (p < end) p++;
+
+    while (p < end)
+    {
+      const char* q = p;
+      while (q < end && (*q == ' ' || *q == '\t' || *q == '\r')) q++;
+
+      if (q < end && *q == '%')
+      {
+        while (q < end && *q != '\n') q++;
+        p = q < end ? q + 1 : q;
+        continue;
+      }
+
+      if (++lines > n) return NOT_METIS;
+
+      for (uint64_t t = 0; next_number(p, end, x, numeric); t++)
+      {
+        if (t < skip || (t - skip) % step) continue;
+        if (x < 1 || x > n) return NOT_METIS;
+        ends++;
+      }
+
+      if (!numeric || ends > 2 * m) return NOT_METIS;
+
+      if (p < end) p++;
+    }
+
+    if (lines == n && ends == 2 * m) return FULL_METIS;
+
+    return lines == n ? NOT_METIS : PARTIAL_METIS;
+  }
+
+  GraphFormat detect_graph_format(GraphFormat format, const char* filename, const char* data, size_t size)
+  {
+    if (format != FORMAT_AUTO) return format;
+
+    if (filename != NULL)
+    {
+      std::string name(filename);
+
+      if (endsWith(name, ".gz")) name.resize(name.size() - 3);
+
+      if (endsWith(name, ".col") || endsWith(name, ".clq") || endsWith(name, ".dimacs")) return FORMAT_DIMACS;
+      if (endsWith(name, ".graph") || endsWith(name, ".metis")) return FORMAT_METIS;
+      if (endsWith(name, ".mtx")) return FORMAT_MTX;
+      if (endsWith(name, ".el") || endsWith(name, ".edges") || endsWith(name, ".edgelist")) return FORMAT_EDGELIST;
+    }
+
+    const char* end = data + size;
+    const char* p = data;
+
+    if (size >= 14 && !memcmp(data, "%%MatrixMarket", 14)) return FORMAT_MTX;
+
+    // skip the blank lines, the first significant character tells the comment style
+    while (p < end && isspace((unsigned char)*p)) p++;
+
+    if (p == end) return FORMAT_DIMACS;
+
+    if (*p == 'c' || *p == 'p' || *p == 'e') return FORMAT_DIMACS;
+    if (*p == '%') return FORMAT_METIS;
+    if (*p == '#') return FORMAT_EDGELIST;
+
+    // headerless numbers: a METIS file is only recognized when its header matches its content,
+    // a content that may still be one (missing lines) is left to the user
+    MetisCheck metis = check_metis(p, end);
+
+    if (metis == FULL_METIS) return FORMAT_METIS;
+    if (metis == PARTIAL_METIS) fprintf(stderr, "ERROR! The input may be a METIS file with missing lines, use -format=metis or -format=edgelist\n"), exit(1);
+
+    // an edge list has two (or three) numbers on every line
+    unsigned int lines = 0;
+    uint64_t x;
+    bool numeric = true;
+
+    while (p < end && lines < 64)
+    {
+      unsigned int tokens = 0;
+
+      while (next_number(p, end, x, numeric)) tokens++;
+
+      if (p < end) p++;
+
+      if (tokens == 0) continue;
+
+      if (tokens != 2 && tokens != 3) fprintf(stderr, "ERROR! Could not tell the format of the input, use -format=metis or -format=edgelist\n"), exit(1);
+
+      lines++;
+    }
+
+    return FORMAT_EDGELIST;
+  }
+
+  MappedFile::MappedFile(const char* filename) : fd(-1), _data(NULL), _size(0)
+  {
+    fd = open(filename, O_RDONLY);
+
+    if (fd < 0) fprintf(stderr, "ERROR! Could not open file: %s\n", filename), exit(1);
+
+    struct stat st;
+
+    if (fstat(fd, &st) < 0) fprintf(stderr, "ERROR! Could not stat file: %s\n", filename), exit(1);
+
+    _size = st.st_size;
+
+    if (_size == 0) return; // mmap refuses empty mappings, an empty buffer is enough
+
+    void* addr = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (addr == MAP_FAILED) fprintf(stderr, "ERROR! Could not map file: %s\n", filename), exit(1);
+
+    madvise(addr, _size, MADV_SEQUENTIAL);
+
+    _data = (const char*) addr;
+  }
+
+  MappedFile::~MappedFile()
+  {
+    if (_data != NULL) munmap((void*) _data, _size);
+    if (fd >= 0) close(fd);
+  }
+
+  GzipStream::GzipStream(gzFile i) : in(i), produced(0), consumed(0), done(false), stop(false), pos(NULL), end(NULL)
+  {
+    gzbuffer(in, 1 << 20);
+
+    for (unsigned int b = 0; b < nb_blocks; b++) blocks[b].resize(block_size), sizes[b] = 0;
+
+    reader = std::thread(&GzipStream::fill, this);
+
+    // the first block is not released, nothing has been consumed yet
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      cv.wait(guard, [this] { return produced > 0 || done; });
+
+      // a block read before an error is parsed first, next() reports the error after it
+      if (produced > 0) { pos = &blocks[0][0], end = pos + sizes[0]; return; }
+    }
+
+    check();
+  }
+
+  GzipStream::~GzipStream()
+  {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stop = true;
+    }
+
+    cv.notify_all();
+    reader.join();
+  }
+
+  void GzipStream::fill()
+  {
+    for (;;)
+    {
+      unsigned int b;
+
+      {
+        std::unique_lock<std::mutex> guard(lock);
+
+        // the blocks not released yet (including the one being parsed) are never overwritten
+        cv.wait(guard, [this] { return stop || produced - consumed < nb_blocks; });
+
+        if (stop) return;
+
+        b = produced % nb_blocks;
+      }
+
+      int n = gzread(in, &blocks[b][0], block_size);
+
+      {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (n <= 0)
+        {
+          int err;
+          const char* msg = gzerror(in, &err);
+
+          // exiting here would leave the lock taken, the parsing thread reports it (check)
+          if (n < 0 || (err != Z_OK && err != Z_STREAM_END)) error = msg;
+
+          done = true;
+        }
+        else
+        {
+          sizes[b] = n;
+          produced++;
+        }
+      }
+
+      cv.notify_all();
+
+      if (n <= 0) return;
+    }
+  }
+
+  void GzipStream::next()
+  {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+
+      consumed++;
+      cv.notify_all();
+
+      cv.wait(guard, [this] { return produced > consumed || done; });
+
+      if (produced > consumed)
+      {
+        unsigned int b = consumed % nb_blocks;
+        pos = &blocks[b][0];
+        end = pos + sizes[b];
+        return;
+      }
+
+      pos = end = NULL;
+    }
+
+    check();
+  }
+
+  void GzipStream::check() const
+  {
+    // the reader thread has returned once done is set, error is not written anymore
+    if (!error.empty()) fprintf(stderr, "ERROR! Could not decompress the input: %s\n", error.c_str()), exit(1);
+  }
+
+  /** Smallest chunk handed to a parsing thread, below that the threads cost more than they save. */
+  static const size_t min_chunk_size = 1 << 20;
+
+  /**
+   * @brief Parses the "e" lines of [begin,end) into packed (min,max) keys, sorted and without duplicates.
+   */
+  static void scan_DIMACS_edges(const char* begin, const char* end, unsigned int nbVertices, std::vector<uint64_t>& keys)
+  {
+    Glucose::MemoryBuffer in(begin, end - begin);
+
+    for (;;)
+    {
+      Glucose::skipWhitespace(in);
+
+      if (isEof(in)) break;
+
+      if (*in == 'e')
+      {
+        ++in;
+
+        int u = Glucose::parseInt(in);
+        int v = Glucose::parseInt(in);
+
+        if (u < 1 || v < 1 || (unsigned)u > nbVertices || (unsigned)v > nbVertices)
+          fprintf(stderr, "PARSE ERROR! Edge %d -- %d is out of range\n", u, v), exit(3);
+
+        if (u > v) std::swap(u, v);
+
+        keys.push_back(((uint64_t)u << 32) | (uint64_t)v);
+      }
+
+      Glucose::skipLine(in);
+    }
+
+    radix_sort_unique(keys);
+  }
+
+  void parse_graph_DIMACS_parallel(const char* data, size_t size, Graph& g, unsigned int nbThreads, ParseTimes& times)
+  {
+    const char* end = data + size;
+
+    Glucose::MemoryBuffer in(data, size);
+
+    bool header = false;
+
+    // the problem line (and the comments before it) are read sequentially
+    while (!header)
+    {
+      Glucose::skipWhitespace(in);
+
+      if (isEof(in)) break;
+
+      if (*in == 'p')
+      {
+        unsigned int nbVertices, nbEdges;
+
+        parse_DIMACS_problem(in, nbVertices, nbEdges);
+
+        g.setDimensions(nbVertices, nbEdges);
+        header = true;
+      }
+      else if (*in == 'e') fprintf(stderr, "PARSE ERROR! Edge found before the problem line\n"), exit(3);
+
+      Glucose::skipLine(in);
+    }
+
+    if (!header) return;
+
+    const char* body = in.position();
+    size_t length = end - body;
+
+    if (nbThreads == 0) nbThreads = std::thread::hardware_concurrency();
+    if (nbThreads == 0) nbThreads = 1;
+    if (nbThreads > length / min_chunk_size) nbThreads = std::max<size_t>(1, length / min_chunk_size);
+
+    auto t_start = std::chrono::high_resolution_clock::now();
+
+    // newline-aligned chunk boundaries
+    std::vector<const char*> bounds(nbThreads + 1);
+    bounds[0] = body;
+    bounds[nbThreads] = end;
+
+    for (unsigned int t = 1; t < nbThreads; t++)
+    {
+      const char* p = std::max(bounds[t-1], body + length / nbThreads * t);
+      while (p < end && p[-1] != '\n') p++;
+      bounds[t] = p;
+    }
+
+    std::vector<std::vector<uint64_t> > buffers(nbThreads);
+    std::vector<std::thread> threads;
+
+    for (unsigned int t = 1; t < nbThreads; t++)
+      threads.push_back(std::thread(scan_DIMACS_edges, bounds[t], bounds[t+1], g.getNbNodes(), std::ref(buffers[t])));
+
+    scan_DIMACS_edges(bounds[0], bounds[1], g.getNbNodes(), buffers[0]);
+
+    for (std::thread& t : threads) t.join();
+
+    auto t_scan = std::chrono::high_resolution_clock::now();
+    times.scan = std::chrono::duration<double, std::milli>(t_scan - t_start).count();
+
+    // k-way merge of the sorted buffers, dropping the duplicates between threads
+    std::vector<uint64_t> keys;
+    size_t total = 0;
+
+    for (auto& b : buffers) total += b.size();
+
+    keys.reserve(total);
+
+    typedef std::pair<uint64_t, unsigned int> Head;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head> > heads;
+    std::vector<size_t> cursors(nbThreads, 0);
+
+    for (unsigned int t = 0; t < nbThreads; t++)
+      if (!buffers[t].empty()) heads.push(Head(buffers[t][0], t));
+
+    while (!heads.empty())
+    {
+      Head h = heads.top(); heads.pop();
+
+      if (keys.empty() || keys.back() != h.first) keys.push_back(h.first);
+
+      if (++cursors[h.second] < buffers[h.second].size()) heads.push(Head(buffers[h.second][cursors[h.second]], h.second));
+      else std::vector<uint64_t>().swap(buffers[h.second]);
+    }
+
+    auto t_merge = std::chrono::high_resolution_clock::now();
+    times.merge = std::chrono::duration<double, std::milli>(t_merge - t_scan).count();
+
+    g.add_unique_edges(keys);
+
+    auto t_build = std::chrono::high_resolution_clock::now();
+    times.build = std::chrono::duration<double, std::milli>(t_build - t_merge).count();
+  }
+
+}
@@ -0,0 +1,512 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#ifndef GRAPH_READER_H
+#define GRAPH_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "utils/ParseUtils.h"
+
+namespace msp {
+
+  class Graph;
+
+  /** @brief the supported graph file formats */
+  enum GraphFormat {
+    FORMAT_AUTO,     /*< detected from the extension and the content */
+    FORMAT_DIMACS,   /*< "p edge N M" then "e u v" lines, 1-based */
+    FORMAT_METIS,    /*< "N M [fmt [ncon]]" then one line of neighbors per vertex, 1-based */
+    FORMAT_EDGELIST, /*< one "u v" pair per line, 0-based, no header */
+    FORMAT_MTX       /*< Matrix Market coordinate format, the pattern of the matrix is the graph */
+  };
+
+  /**
+   * @brief Sorts packed (min,max) edge keys and removes the duplicates.
+   *
+   * LSD radix sort on 16-bit digits, the digits on which all the keys agree are skipped
+   * (with ids below 65536 only two of the four passes are done).
+   */
+  void radix_sort_unique(std::vector<uint64_t>& keys);
+
+  /** Returns the format named by the -format option, exits on unknown names. */
+  GraphFormat graph_format_from_name(const char* name);
+
+  const char* graph_format_name(GraphFormat format);
+
+  /**
+   * @brief Resolves FORMAT_AUTO from the extension of the file name (".gz" ignored) and, failing that,
+   * from the first bytes of the content.
+   *
+   * Headerless numbers are METIS only if the header matches the whole content, an edge list if every line
+   * has two or three numbers; exits asking for -format= when they are neither.
+   */
+  GraphFormat detect_graph_format(GraphFormat format, const char* filename, const char* data, size_t size);
+
+  /** @brief Time spent (in ms) in each phase of the parallel parser. */
+  struct ParseTimes {
+
+    double scan;  /*< per-chunk parsing of the "e" lines */
+
+    double merge; /*< merge and deduplication of the per-thread buffers */
+
+    double build; /*< insertion of the unique edges and construction of the adjacency */
+
+    ParseTimes() : scan(0), merge(0), build(0) { }
+  };
+
+  /**
+   * @brief Header of the binary graph snapshots (written by Graph::save_binary).
+   *
+   * It is followed by the CSR offsets (nbVertices+2 uint64_t), the CSR neighbors (nbAdj uint32_t),
+   * then, if the corresponding flag is set, the elimination order (nbOrder uint32_t) and the
+   * triangles (3*nbTriplets uint32_t). Integers are stored in the byte order of the machine.
+   * The triangles are only reused with the heuristic that computed them.
+   */
+  struct GraphSnapshotHeader {
+
+    static const uint32_t current_version = 3;
+
+    static const uint32_t has_order    = 1; /*< _nodes and the treewidth bounds are stored */
+
+    static const uint32_t has_triplets = 2; /*< setOfTriplets is stored */
+
+    static const uint32_t min_clique   = 4; /*< the triangles come from an order minimizing the clique (-portfolio-clique) */
+
+    static const uint32_t from_td_file = 0xFFFFFFFF; /*< heuristic of the triangles read from a .td file */
+
+    char magic[8];
+
+    uint32_t version;
+
+    uint32_t flags;
+
+    uint32_t nbVertices;
+
+    uint32_t nbEdges;
+
+    uint64_t nbAdj;
+
+    uint32_t l_width, u_width;
+
+    double l_wwidth, u_wwidth;
+
+    uint64_t nbOrder;
+
+    uint64_t nbTriplets;
+
+    uint32_t heuristic; /*< OrderingHeuristic of the triangles, or from_td_file */
+
+    uint32_t reserved;
+  };
+
+  /** @brief the first bytes of every binary graph snapshot */
+  static const char graph_snapshot_magic[8] = { 'G', 'C', 'O', 'L', 'B', 'I', 'N', '\0' };
+
+  /** Returns true if the content starts like a binary graph snapshot. */
+  inline bool is_graph_snapshot(const char* data, size_t size)
+  {
+    return size >= sizeof(GraphSnapshotHeader) && !memcmp(data, graph_snapshot_magic, sizeof(graph_snapshot_magic));
+  }
+
+  /**
+   * @brief Read-only memory mapping of a whole file.
+   *
+   * The content is accessed in place, nothing is copied. The mapping is released
+   * when the object is destroyed.
+   */
+  class MappedFile {
+
+  private:
+
+    int fd;
+
+    const char* _data;
+
+    size_t _size;
+
+  public:
+
+    explicit MappedFile(const char* filename);
+
+    ~MappedFile();
+
+    inline const char* data() const { return _data; }
+
+    inline size_t size() const { return _size; }
+
+  };
+
+  /** Returns true if the content starts with the gzip magic number. */
+  inline bool is_gzip(const char* data, size_t size)
+  {
+    return size >= 2 && (unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b;
+  }
+
+  /**
+   * @brief A character stream decompressing a gzFile on a separate thread.
+   *
+   * A reader thread fills a ring of large blocks with gzread() while the parser consumes them,
+   * so decompression and parsing overlap. Uncompressed input is read as is (zlib passes it through).
+   * The gzFile is not closed by the stream.
+   */
+  class GzipStream {
+
+  private:
+
+    static const size_t block_size = 4 << 20;
+
+    static const unsigned int nb_blocks = 3;
+
+    gzFile in;
+
+    std::vector<unsigned char> blocks[nb_blocks];
+
+    int sizes[nb_blocks];
+
+    uint64_t produced, consumed; /*< number of blocks filled by the reader, released by the parser */
+
+    bool done, stop;
+
+    std::string error; /*< zlib message of a failed read, reported by the parsing thread */
+
+    std::mutex lock;
+
+    std::condition_variable cv;
+
+    std::thread reader;
+
+    const unsigned char* pos;
+
+    const unsigned char* end;
+
+    /** Body of the reader thread. */
+    void fill();
+
+    /** Releases the current block and waits for the next one, pos == end afterwards means end of file. */
+    void next();
+
+    /** Exits with the error of the reader thread if there is one, called without the lock. */
+    void check() const;
+
+  public:
+
+    explicit GzipStream(gzFile i);
+
+    ~GzipStream();
+
+    inline int  operator *  () const { return (pos >= end) ? EOF : *pos; }
+    inline void operator ++ ()       { if (pos < end && ++pos >= end) next(); }
+
+    /** The data not parsed yet in the current block (used to detect the format). */
+    inline const char* peek() const { return (const char*) pos; }
+    inline size_t available() const { return end - pos; }
+  };
+
+  static inline bool isEof(GzipStream& in) { return *in == EOF; }
+
+  /**
+   * @brief Parses the DIMACS problem line "p edge N M", the stream must point to the 'p'.
+   */
+  template<class B>
+  static void parse_DIMACS_problem(B& in, unsigned int& nbVertices, unsigned int& nbEdges)
+  {
+    ++in;
+    Glucose::skipWhitespace(in);
+
+    // skip the format name ("edge", "col", ...)
+    while (!isEof(in) && *in != ' ' && *in != '\t' && *in != '\n') ++in;
+
+    int n = Glucose::parseInt(in);
+    int m = Glucose::parseInt(in);
+
+    if (n < 0 || m < 0) fprintf(stderr, "PARSE ERROR! Negative size in the problem line\n"), exit(3);
+
+    nbVertices = n;
+    nbEdges    = m;
+  }
+
+  /**
+   * @brief Parses a graph in the DIMACS format (lines "c", "p edge N M" and "e u v").
+   *
+   * Scans the stream in place with the Glucose parsing functions, the graph only
+   * receives the header through setDimensions() and then each edge through add_edge().
+   *
+   * @param[in] in the character stream (StreamBuffer, MemoryBuffer, ...)
+   * @param[in,out] g the graph to fill
+   */
+  template<class B, class G>
+  static void parse_graph_DIMACS(B& in, G& g)
+  {
+    bool header = false;
+
+    for (;;)
+    {
+      Glucose::skipWhitespace(in);
+
+      if (isEof(in)) break;
+
+      if (*in == 'p')
+      {
+        unsigned int nbVertices, nbEdges;
+
+        parse_DIMACS_problem(in, nbVertices, nbEdges);
+
+        g.setDimensions(nbVertices, nbEdges);
+        header = true;
+      }
+      else if (*in == 'e')
+      {
+        ++in;
+
+        int u = Glucose::parseInt(in);
+        int v = Glucose::parseInt(in);
+
+        if (!header) fprintf(stderr, "PARSE ERROR! Edge found before the problem line\n"), exit(3);
+        if (u < 1 || v < 1 || (unsigned)u > g.getNbNodes() || (unsigned)v > g.getNbNodes())
+          fprintf(stderr, "PARSE ERROR! Edge %d -- %d is out of range\n", u, v), exit(3);
+
+        g.add_edge(u, v);
+      }
+
+      Glucose::skipLine(in);
+    }
+  }
+
+  /** Skips spaces and tabs, but not the end of the line. */
+  template<class B>
+  static void skipBlanks(B& in)
+  {
+    while (*in == ' ' || *in == '\t' || *in == '\r') ++in;
+  }
+
+  /**
+   * @brief Parses a graph in the METIS format.
+   *
+   * The header "N M [fmt [ncon]]" is followed by one line per vertex listing its neighbors,
+   * possibly preceded by the vertex size and weights and followed by edge weights, according to fmt.
+   * Lines starting with '%' are comments, an empty line is a vertex without neighbors.
+   * The lines of the last vertices may be missing at the end of the file: they have no neighbors.
+   */
+  template<class B, class G>
+  static void parse_graph_METIS(B& in, G& g)
+  {
+    // comments and blank lines before the header
+    for (;;)
+    {
+      Glucose::skipWhitespace(in);
+      if (*in == '%') Glucose::skipLine(in);
+      else break;
+    }
+
+    if (isEof(in)) return;
+
+    int n = Glucose::parseInt(in);
+    int m = Glucose::parseInt(in);
+
+    if (n < 0 || m < 0) fprintf(stderr, "PARSE ERROR! Negative size in the METIS header\n"), exit(3);
+
+    // fmt is up to three binary digits: vertex sizes, vertex weights, edge weights
+    int fmt = 0, ncon = 1;
+
+    skipBlanks(in);
+    if (*in >= '0' && *in <= '9') fmt = Glucose::parseInt(in);
+
+    skipBlanks(in);
+    if (*in >= '0' && *in <= '9') ncon = Glucose::parseInt(in);
+
+    bool hasSizes = (fmt / 100) % 10, hasVertexWeights = (fmt / 10) % 10, hasEdgeWeights = fmt % 10;
+
+    Glucose::skipLine(in);
+
+    g.setDimensions(n, m);
+
+    for (int v = 1; v <= n; )
+    {
+      // the remaining vertices are isolated, the writers often drop their empty lines
+      if (isEof(in)) break;
+
+      skipBlanks(in);
+
+      if (*in == '%') { Glucose::skipLine(in); continue; }
+
+      if (hasSizes) Glucose::parseInt(in);
+      if (hasVertexWeights) for (int c = 0; c < ncon; c++) Glucose::parseInt(in);
+
+      for (;;)
+      {
+        skipBlanks(in);
+
+        if (isEof(in) || *in == '\n') break;
+
+        int u = Glucose::parseInt(in);
+
+        if (u < 1 || u > n) fprintf(stderr, "PARSE ERROR! Neighbor %d of vertex %d is out of range\n", u, v), exit(3);
+
+        if (hasEdgeWeights) skipBlanks(in), Glucose::parseInt(in);
+
+        g.add_edge(v, u);
+      }
+
+      Glucose::skipLine(in);
+      v++;
+    }
+  }
+
+  /**
+   * @brief Parses a graph given as a plain list of 0-based "u v" pairs (one per line, extra columns ignored).
+   *
+   * Lines starting with '#' or '%' are comments. As there is no header, the edges are collected and
+   * deduplicated before the graph is dimensioned from the largest id.
+   */
+  template<class B, class G>
+  static void parse_graph_edgelist(B& in, G& g)
+  {
+    std::vector<uint64_t> keys;
+    unsigned int nbVertices = 0, nbLines = 0;
+
+    for (;;)
+    {
+      Glucose::skipWhitespace(in);
+
+      if (isEof(in)) break;
+
+      if (*in == '#' || *in == '%') { Glucose::skipLine(in); continue; }
+
+      int u = Glucose::parseInt(in);
+      skipBlanks(in);
+      int v = Glucose::parseInt(in);
+
+      if (u < 0 || v < 0) fprintf(stderr, "PARSE ERROR! Negative vertex in edge %d -- %d\n", u, v), exit(3);
+
+      // shift to the 1-based ids used everywhere else
+      uint64_t a = u + 1, b = v + 1;
+      if (a > b) std::swap(a, b);
+
+      if (b > nbVertices) nbVertices = b;
+
+      keys.push_back((a << 32) | b);
+      nbLines++;
+
+      Glucose::skipLine(in);
+    }
+
+    radix_sort_unique(keys);
+
+    g.setDimensions(nbVertices, nbLines);
+    g.add_unique_edges(keys);
+  }
+
+  /**
+   * @brief Parses a graph given as a Matrix Market coordinate file.
+   *
+   * Every off-diagonal entry (i,j) is an edge i -- j, the values (if any) are ignored.
+   */
+  template<class B, class G>
+  static void parse_graph_MTX(B& in, G& g)
+  {
+    if (!Glucose::eagerMatch(in, "%%MatrixMarket")) fprintf(stderr, "PARSE ERROR! Missing %%%%MatrixMarket banner\n"), exit(3);
+
+    skipBlanks(in);
+
+    if (!Glucose::eagerMatch(in, "matrix")) fprintf(stderr, "PARSE ERROR! Only Matrix Market matrices are supported\n"), exit(3);
+
+    skipBlanks(in);
+
+    if (!Glucose::eagerMatch(in, "coordinate")) fprintf(stderr, "PARSE ERROR! Only the Matrix Market coordinate format is supported\n"), exit(3);
+
+    Glucose::skipLine(in);
+
+    for (;;)
+    {
+      Glucose::skipWhitespace(in);
+      if (*in == '%') Glucose::skipLine(in);
+      else break;
+    }
+
+    int rows = Glucose::parseInt(in);
+    int cols = Glucose::parseInt(in);
+    int nnz  = Glucose::parseInt(in);
+
+    if (rows < 0 || cols < 0 || nnz < 0) fprintf(stderr, "PARSE ERROR! Negative size in the Matrix Market header\n"), exit(3);
+
+    Glucose::skipLine(in);
+
+    unsigned int n = std::max(rows, cols);
+
+    g.setDimensions(n, nnz);
+
+    for (;;)
+    {
+      Glucose::skipWhitespace(in);
+
+      if (isEof(in)) break;
+
+      if (*in == '%') { Glucose::skipLine(in); continue; }
+
+      int i = Glucose::parseInt(in);
+      int j = Glucose::parseInt(in);
+
+      if (i < 1 || j < 1 || (unsigned)i > n || (unsigned)j > n)
+        fprintf(stderr, "PARSE ERROR! Entry (%d,%d) is out of range\n", i, j), exit(3);
+
+      if (i != j) g.add_edge(i, j);
+
+      Glucose::skipLine(in);
+    }
+  }
+
+  /** Parses a graph in the given format (which must not be FORMAT_AUTO anymore). */
+  template<class B, class G>
+  static void parse_graph(B& in, G& g, GraphFormat format)
+  {
+    switch (format)
+    {
+      case FORMAT_METIS:    parse_graph_METIS(in, g); break;
+      case FORMAT_EDGELIST: parse_graph_edgelist(in, g); break;
+      case FORMAT_MTX:      parse_graph_MTX(in, g); break;
+      default:              parse_graph_DIMACS(in, g); break;
+    }
+  }
+
+  /**
+   * @brief Parses a graph in the DIMACS format from memory using several threads.
+   *
+   * The problem line is read first, then the rest of the buffer is split in newline-aligned chunks
+   * whose "e" lines are parsed by one thread each into a local buffer of packed (min,max) keys.
+   * The buffers are merged and deduplicated, and the unique edges are finally added to the graph.
+   *
+   * @param[in] data the content of the file
+   * @param[in] size the size of the content
+   * @param[in,out] g the graph to fill
+   * @param[in] nbThreads the maximal number of threads (0: one per core)
+   * @param[out] times the time spent in each phase
+   */
+  void parse_graph_DIMACS_parallel(const char* data, size_t size, Graph& g, unsigned int nbThreads, ParseTimes& times);
+
+}
+
+#endif
@@ -0,0 +1,308 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "LowerBound.h"
+#include "Graph.h"
+#include "mtl/Heap.h"
+#include <algorithm>
+
+namespace msp {
+
+  /** Orders the vertices of the contraction heap: smallest degree first, then smallest id. */
+  struct DegreeOrder
+  {
+    const std::vector<std::vector<unsigned int>>* adj;
+
+    bool operator()(int a, int b) const { return (*adj)[a].size() < (*adj)[b].size() || ((*adj)[a].size() == (*adj)[b].size() && a < b); }
+  };
+
+  /** Inserts x in the sorted vector if it is not there yet. */
+  static inline void sorted_insert(std::vector<unsigned int>& v, unsigned int x)
+  {
+    auto it = std::lower_bound(v.begin(), v.end(), x);
+    if (it == v.end() || *it != x) v.insert(it, x);
+  }
+
+  static inline void sorted_erase(std::vector<unsigned int>& v, unsigned int x)
+  {
+    auto it = std::lower_bound(v.begin(), v.end(), x);
+    if (it != v.end() && *it == x) v.erase(it);
+  }
+
+  unsigned int contraction_lower_bound(const Graph& g, ContractionStrategy strategy)
+  {
+    unsigned int n = g.getNbNodes();
+
+    // the contracted graph, as sorted neighbor lists without self-loops
+    std::vector<std::vector<unsigned int>> adj(n+1);
+    std::vector<unsigned int> stamp(n+1, 0);
+
+    for (unsigned int v = 1; v <= n; v++)
+      for (unsigned int x: g.neighbors(v))
+        if (x != v) adj[v].push_back(x);
+
+    DegreeOrder lt = { &adj };
+    Glucose::Heap<DegreeOrder> heap(lt);
+
+    for (unsigned int v = 1; v <= n; v++) heap.insert(v);
+
+    unsigned int bound = 0;
+
+    while (heap.size() > 1)
+    {
+      unsigned int v = heap.removeMin();
+
+      if (adj[v].size() > bound) bound = adj[v].size();
+
+      if (adj[v].empty()) continue;
+
+      // the vertices left have less than heap.size() neighbors, the bound cannot grow anymore
+      if (bound >= (unsigned int)heap.size()) break;
+
+      // choose the neighbor u to contract v into
+      unsigned int u = 0;
+      size_t best = 0;
+
+      if (strategy == CONTRACT_LEAST_C) for (unsigned int x: adj[v]) stamp[x] = v;
+
+      for (unsigned int x: adj[v])
+      {
+        size_t cost = adj[x].size();
+
+        if (strategy == CONTRACT_LEAST_C)
+        {
+          cost = 0;
+          for (unsigned int y: adj[x]) if (stamp[y] == v) cost++;
+        }
+
+        if (u == 0 || cost < best || (cost == best && adj[x].size() < adj[u].size())) { u = x; best = cost; }
+      }
+
+      // contract the edge v -- u: u takes the neighbors of v
+      for (unsigned int x: adj[v])
+      {
+        sorted_erase(adj[x], v);
+
+        if (x != u)
+        {
+          sorted_insert(adj[x], u);
+          sorted_insert(adj[u], x);
+        }
+
+        heap.update(x);
+      }
+
+      heap.update(u);
+
+      std::vector<unsigned int>().swap(adj[v]);
+    }
+
+    return bound;
+  }
+
+  /** Core number of each vertex (Batagelj and Zaversnik 2003), with a bucket queue on the degrees. */
+  static void core_numbers(const Graph& g, std::vector<unsigned int>& core)
+  {
+    unsigned int n = g.getNbNodes();
+
+    std::vector<unsigned int> degree(n+1, 0), start(n+2, 0), vertexAt(n+1, 0), position(n+1, 0);
+    unsigned int maxDegree = 0;
+
+    for (unsigned int v = 1; v <= n; v++)
+    {
+      for (unsigned int x: g.neighbors(v)) if (x != v) degree[v]++;
+      maxDegree = std::max(maxDegree, degree[v]);
+    }
+
+    // the vertices sorted by degree, start[d] is the first one of degree d
+    for (unsigned int v = 1; v <= n; v++) start[degree[v]+1]++;
+    for (unsigned int d = 1; d <= maxDegree + 1; d++) start[d] += start[d-1];
+    for (unsigned int v = 1; v <= n; v++) { position[v] = start[degree[v]]++; vertexAt[position[v]] = v; }
+    for (unsigned int d = maxDegree + 1; d >= 1; d--) start[d] = start[d-1];
+    start[0] = 0;
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+      unsigned int v = vertexAt[i];
+
+      for (unsigned int x: g.neighbors(v))
+      {
+        if (x == v || degree[x] <= degree[v]) continue;
+
+        // x moves to the front of its bucket, which then starts one later
+        unsigned int d = degree[x], y = vertexAt[start[d]];
+        if (y != x)
+        {
+          std::swap(vertexAt[position[x]], vertexAt[start[d]]);
+          position[y] = position[x];
+          position[x] = start[d];
+        }
+        start[d]++;
+        degree[x]--;
+      }
+    }
+
+    core.swap(degree);
+  }
+
+  /** The bitset branch and bound of max_clique, over the vertices 0..m-1 of adj. */
+  struct CliqueSearch
+  {
+    size_t words;
+    const std::vector<uint64_t>* adj; // adj[v * words ..] is the neighborhood of v
+    std::vector<unsigned int> current, best;
+    uint64_t nodes, nodeLimit;
+
+    void expand(std::vector<uint64_t>& candidates)
+    {
+      if (++nodes > nodeLimit) return;
+
+      // greedy coloring of the candidates: the color of a vertex bounds the clique it can still give
+      std::vector<unsigned int> order, bound;
+      std::vector<uint64_t> uncolored(candidates), klass(words);
+      unsigned int color = 0;
+
+      for (bool left = true; left; )
+      {
+        color++;
+        klass = uncolored;
+
+        for (size_t w = 0; w < words; w++)
+        {
+          while (klass[w])
+          {
+            unsigned int v = (unsigned int)(w * 64 + __builtin_ctzll(klass[w]));
+            klass[w] &= klass[w] - 1;
+            uncolored[w] &= ~((uint64_t)1 << (v & 63));
+
+            const uint64_t* n_v = &(*adj)[(size_t)v * words];
+            for (size_t u = w; u < words; u++) klass[u] &= ~n_v[u];
+
+            order.push_back(v);
+            bound.push_back(color);
+          }
+        }
+
+        left = false;
+        for (size_t w = 0; w < words && !left; w++) left = uncolored[w] != 0;
+      }
+
+      std::vector<uint64_t> next(words);
+
+      for (size_t i = order.size(); i-- > 0; )
+      {
+        if (current.size() + bound[i] <= best.size() || nodes > nodeLimit) return;
+
+        unsigned int v = order[i];
+        const uint64_t* n_v = &(*adj)[(size_t)v * words];
+
+        bool empty = true;
+        for (size_t w = 0; w < words; w++) { next[w] = candidates[w] & n_v[w]; empty = empty && next[w] == 0; }
+
+        current.push_back(v);
+        if (empty) { if (current.size() > best.size()) best = current; }
+        else expand(next);
+        current.pop_back();
+
+        candidates[v >> 6] &= ~((uint64_t)1 << (v & 63));
+      }
+    }
+  };
+
+  bool max_clique(const Graph& g, std::vector<unsigned int>& clique, uint64_t nodeLimit)
+  {
+    unsigned int n = g.getNbNodes();
+
+    clique.clear();
+    if (n == 0) return true;
+
+    std::vector<unsigned int> core;
+    core_numbers(g, core);
+
+    // greedy: from each vertex, add the neighbors of highest core number adjacent to the whole clique
+    std::vector<unsigned int> byCore;
+    for (unsigned int v = 1; v <= n; v++) byCore.push_back(v);
+    std::stable_sort(byCore.begin(), byCore.end(), [&core](unsigned int a, unsigned int b) { return core[a] > core[b]; });
+
+    clique.push_back(byCore[0]);
+
+    std::vector<unsigned int> candidates, grown;
+
+    for (unsigned int v: byCore)
+    {
+      // a clique of more than |clique| vertices has all its vertices of core number |clique| at least
+      if (core[v] < clique.size()) break;
+
+      candidates.clear();
+      for (unsigned int x: g.neighbors(v)) if (x != v && core[x] >= clique.size()) candidates.push_back(x);
+      std::stable_sort(candidates.begin(), candidates.end(), [&core](unsigned int a, unsigned int b) { return core[a] > core[b]; });
+
+      grown.assign(1, v);
+      for (unsigned int x: candidates)
+      {
+        bool all = true;
+        for (unsigned int y: grown) if (!g.are_nodes_connected(x, y)) { all = false; break; }
+        if (all) grown.push_back(x);
+      }
+
+      if (grown.size() > clique.size()) clique.swap(grown);
+    }
+
+    // exact search over the vertices which could still be in a larger clique
+    std::vector<unsigned int> kept, index(n+1, ~0u);
+    for (unsigned int v = 1; v <= n; v++) if (core[v] >= clique.size()) { index[v] = kept.size(); kept.push_back(v); }
+
+    bool exact = kept.size() <= clique.size();
+
+    if (!exact && kept.size() <= 16384)
+    {
+      CliqueSearch search;
+      search.words = (kept.size() + 63) / 64;
+
+      std::vector<uint64_t> adj(kept.size() * search.words, 0), all(search.words, 0);
+
+      for (size_t i = 0; i < kept.size(); i++)
+      {
+        all[i >> 6] |= (uint64_t)1 << (i & 63);
+        for (unsigned int x: g.neighbors(kept[i]))
+          if (x != kept[i] && index[x] != ~0u) adj[i * search.words + (index[x] >> 6)] |= (uint64_t)1 << (index[x] & 63);
+      }
+
+      search.adj = &adj;
+      search.nodes = 0;
+      search.nodeLimit = nodeLimit;
+      search.best.assign(clique.size(), 0); // only a larger clique replaces the greedy one
+
+      search.expand(all);
+
+      exact = search.nodes <= nodeLimit;
+
+      if (search.best.size() > clique.size())
+      {
+        clique.clear();
+        for (unsigned int i: search.best) clique.push_back(kept[i]);
+      }
+    }
+
+    std::sort(clique.begin(), clique.end());
+
+    return exact;
+  }
+
+}
@@ -0,0 +1,61 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+
+#ifndef LOWER_BOUND_H
+#define LOWER_BOUND_H
+
+#include <vector>
+#include <stdint.h>
+
+namespace msp {
+
+  class Graph;
+
+  /** @brief how the contraction partner of the minimum degree vertex is chosen */
+  enum ContractionStrategy {
+    CONTRACT_MIN_D,   /*< the neighbor of minimum degree (minor-min-width) */
+    CONTRACT_LEAST_C  /*< the neighbor with the fewest common neighbors */
+  };
+
+  /**
+   * @brief MMD+ lower bound on the treewidth (Bodlaender, Koster and Wolle 2004).
+   *
+   * Repeatedly takes a vertex v of minimum degree, records its degree and contracts the edge between
+   * v and one of its neighbors. The largest recorded degree is the degree of a minor of the graph,
+   * hence a lower bound on its treewidth (never below the degeneracy).
+   */
+  unsigned int contraction_lower_bound(const Graph& g, ContractionStrategy strategy);
+
+  /**
+   * @brief A large clique, a lower bound on the chromatic number (and on the treewidth plus one).
+   *
+   * A greedy clique is grown from every vertex whose core number can beat the best one, then a branch and
+   * bound (San Segundo's bitset version of Tomita's MCQ, with a greedy coloring as bound) searches the
+   * vertices left by this core pruning, as long as they are at most 16384.
+   *
+   * @param nodeLimit the number of branch and bound nodes after which the best clique so far is kept
+   * @param[out] clique the vertices of the clique, by increasing id
+   * @return true if the clique is proven maximum
+   */
+  bool max_clique(const Graph& g, std::vector<unsigned int>& clique, uint64_t nodeLimit);
+
+}
+
+#endif
@@ -36,6 +36,88 @@ inline int myLit(Lit l)
     return sign(l) ? -(var(l)) : (var(l));
 }
 
+/* Returns true if the option is given anywhere on the command line. */
+static bool hasOption(int argc, char** argv, const char* option)
+{
+	for(int i = 1; i < argc; i++) if(!strcmp(option, argv[i])) return true;
+	return false;
+}
+
+/* Returns the value of an option given as "-name=value", NULL if the option is not given. */
+static const char* optionValue(int argc, char** argv, const char* prefix)
+{
+	size_t len = strlen(prefix);
+	for(int i = 1; i < argc; i++) if(!strncmp(prefix, argv[i], len)) return argv[i] + len;
+	return NULL;
+}
+
+/* Returns the first argument which is not an option (the graph file), NULL to read stdin. */
+static const char* inputFile(int argc, char** argv)
+{
+	for(int i = 1; i < argc; i++) if(argv[i][0] != '-') return argv[i];
+	return NULL;
+}
+
+/* How the color-minimization loop chooses the next bound k to probe. */
+enum SearchStrategy {
+	SEARCH_LINEAR,     /* one color less than the best coloring, until UNSAT */
+	SEARCH_BINARY,     /* the middle of the interval between the lower bound and the best coloring */
+	SEARCH_PROGRESSIVE /* conflict-budgeted probes below the best coloring and at the lower bound, the budget doubles when both time out */
+};
+
+/* Returns the strategy called name (linear, binary or progressive), exits on an unknown name. */
+static SearchStrategy search_from_name(const char* name)
+{
+	if (!strcmp(name, "linear"))      return SEARCH_LINEAR;
+	if (!strcmp(name, "binary"))      return SEARCH_BINARY;
+	if (!strcmp(name, "progressive")) return SEARCH_PROGRESSIVE;
+
+	fprintf(stderr, "ERROR! Unknown search strategy: %s (linear, binary or progressive)\n", name), exit(1);
+}
+
+static const char* search_name(SearchStrategy strategy)
+{
+	switch(strategy)
+	{
+		case SEARCH_BINARY:      return "binary";
+		case SEARCH_PROGRESSIVE: return "progressive";
+		default:                 return "linear";
+	}
+}
+
+/* Encodes the graph in a fresh solver and descends on k until the conflict budget is spent: returns the propagations per second. */
+static double benchPropagation(Graph* graph, const EncodingOptions& options, bool ternaryWatches, int64_t conflictBudget)
+{
+	Glucose::SimpSolver solver;
+	solver.setIncrementalMode();
+	solver.verbosity = 0;
+	solver.adaptStrategies = false;
+	solver.useTernaryWatches = ternaryWatches;
+
+	SAT_Encoding encoding(graph,&solver,options);
+
+	unsigned int k = encoding.getMaxColors();
+	vec<Lit> assumptions;
+	encoding.boundColors(&solver,k,assumptions);
+
+	auto t_start = chrono::high_resolution_clock::now();
+
+	while(k > 0 && (int64_t)solver.conflicts < conflictBudget)
+	{
+		solver.setConfBudget(conflictBudget - solver.conflicts);
+		if(solver.solveLimited(assumptions) != l_True) break;
+		if(--k > 0) encoding.boundColors(&solver,k,assumptions);
+	}
+
+	auto t_end = chrono::high_resolution_clock::now();
+	double elaspedTimeMs = std::chrono::duration<double, std::milli>(t_end-t_start).count();
+
+	printf("c | %-8s watches : k = %5u | %12" PRIu64 " propagations | %12" PRIu64 " conflicts | %12.5f ms\n",
+		ternaryWatches ? "ternary" : "generic",k,solver.propagations,solver.conflicts,elaspedTimeMs);
+
+	return elaspedTimeMs > 0 ? solver.propagations / (elaspedTimeMs / 1000.0) : 0;
+}
+
 
 int main(int argc, char** argv)
 {
@@ -51,26 +133,98 @@ int main(int argc, char** argv)
 	cout << "c |-------------------------------------------------------------------------------------------------------|" << endl;
 
 	setbuf( stdout , NULL );
-	bool res = true;
 	bool toPrintModel = false;
 	double elaspedTimeMs = 0.0f;
 	Glucose::SimpSolver glucose;
 
 	vector<bool> copy_model;
 
-	if ( (argc > 1 && !strcmp("-t", argv[1])) || (argc > 2 && !strcmp("-t", argv[2])) )
+	TriangulationOptions triangulationOptions;
+
+	if ( hasOption(argc, argv, "-t") )
 	{
 		triangulation = true;
 	}
 
-	if ( (argc > 1 && !strcmp("-print", argv[1])) || (argc > 2 && !strcmp("-print", argv[2])) )
+	if ( optionValue(argc, argv, "-t=") )
+	{
+		triangulation = true;
+		triangulationOptions.heuristic = ordering_from_name(optionValue(argc, argv, "-t="));
+	}
+
+	if ( optionValue(argc, argv, "-portfolio-runs=") )
+	{
+		triangulationOptions.portfolioRuns = atoi(optionValue(argc, argv, "-portfolio-runs="));
+	}
+
+	if ( optionValue(argc, argv, "-portfolio-threads=") )
+	{
+		triangulationOptions.portfolioThreads = atoi(optionValue(argc, argv, "-portfolio-threads="));
+	}
+
+	if ( optionValue(argc, argv, "-portfolio-time=") )
+	{
+		triangulationOptions.portfolioTime = atof(optionValue(argc, argv, "-portfolio-time="));
+	}
+
+	if ( optionValue(argc, argv, "-t-max-lb=") )
+	{
+		triangulationOptions.maxLowerBound = atoi(optionValue(argc, argv, "-t-max-lb="));
+	}
+
+	if ( optionValue(argc, argv, "-t-cache=") )
+	{
+		triangulationOptions.cacheDir = optionValue(argc, argv, "-t-cache=");
+	}
+
+	if ( optionValue(argc, argv, "-td-in=") )
+	{
+		triangulation = true;
+		triangulationOptions.tdInput = optionValue(argc, argv, "-td-in=");
+	}
+
+	if ( hasOption(argc, argv, "-portfolio-clique") )
+	{
+		triangulationOptions.minimizeClique = true;
+	}
+
+	if ( hasOption(argc, argv, "-print") )
 	{
 		toPrintModel = true;
 	}	
 	
-	Graph graph(triangulation);
+	unsigned int nbParseThreads = 0;
+
+	if ( optionValue(argc, argv, "-parse-threads=") )
+	{
+		nbParseThreads = atoi(optionValue(argc, argv, "-parse-threads="));
+	}
+
+	GraphFormat format = FORMAT_AUTO;
+
+	if ( optionValue(argc, argv, "-format=") )
+	{
+		format = graph_format_from_name(optionValue(argc, argv, "-format="));
+	}
+
+	Graph graph(triangulation, inputFile(argc, argv), nbParseThreads, format, triangulationOptions);
+
+	if ( hasOption(argc, argv, "-lb") )
+	{
+		graph.improve_lower_bound();
+	}
+
+	if ( optionValue(argc, argv, "-td-out=") )
+	{
+		write_td(optionValue(argc, argv, "-td-out="), graph, graph.ordering());
+	}
+
+	if ( optionValue(argc, argv, "-save-bin=") )
+	{
+		graph.save_binary(optionValue(argc, argv, "-save-bin="));
+	}
 
-	if ( (argc > 1 && !strcmp("-dot", argv[1])) || (argc > 2 && !strcmp("-dot", argv[2])) )
+	if ( hasOption(argc, argv, "-dot") )
 	{
 		graph.toDOT(stderr);
 		cerr << endl;
@@ -81,7 +235,111 @@ int main(int argc, char** argv)
 	glucose.verbosity = 0;
 	glucose.adaptStrategies = false;
 	
-	SAT_Encoding sat_encoding(&graph,&glucose);	
+	EncodingOptions encodingOptions;
+
+	if ( optionValue(argc, argv, "-enc=") )
+	{
+		encodingOptions.kind = encoding_from_name(optionValue(argc, argv, "-enc="));
+	}
+
+	if ( optionValue(argc, argv, "-colors=") )
+	{
+		encodingOptions.nbColors = atoi(optionValue(argc, argv, "-colors="));
+	}
+
+	/* -lazy: transitivity clauses only once a model violates them (not with -maxsat, which needs them all). */
+	if ( hasOption(argc, argv, "-lazy") && !hasOption(argc, argv, "-maxsat") )
+	{
+		encodingOptions.lazy = true;
+	}
+
+	/* -native: the solver propagates the transitivity of the pairs itself, without clauses. */
+	if ( hasOption(argc, argv, "-native") && !hasOption(argc, argv, "-maxsat") )
+	{
+		encodingOptions.native = true;
+	}
+
+	/* A clique gives a lower bound: the loop stops at its size, and the assignment encoding gives its vertices the first colors (-no-clique skips it). */
+	vector<unsigned int> clique;
+
+	if ( !hasOption(argc, argv, "-no-clique") && !hasOption(argc, argv, "-maxsat") )
+	{
+		uint64_t nodeLimit = 100000;
+
+		if ( optionValue(argc, argv, "-clique-nodes=") )
+		{
+			nodeLimit = atoll(optionValue(argc, argv, "-clique-nodes="));
+		}
+
+		auto t_start = chrono::high_resolution_clock::now();
+
+		bool exact = max_clique(graph, clique, nodeLimit);
+
+		auto t_end = chrono::high_resolution_clock::now();
+		elaspedTimeMs = std::chrono::duration<double, std::milli>(t_end-t_start).count();
+		printf("c | Lower bound: %u colors (%s clique) in %4.5f ms\n",(unsigned int)clique.size(),exact ? "maximum" : "largest found",elaspedTimeMs);
+
+		if ( encodingOptions.kind == ENCODING_ASSIGNMENT ) encodingOptions.clique = clique;
+	}
+
+	/* The first bound comes from a heuristic coloring: DSATUR then -ub-runs= randomized greedy runs (-no-ub skips it). */
+	vector<unsigned int> heuristicColor;
+	unsigned int heuristicColors = 0;
+
+	if ( !hasOption(argc, argv, "-no-ub") && !hasOption(argc, argv, "-maxsat") )
+	{
+		unsigned int runs = 20;
+
+		if ( optionValue(argc, argv, "-ub-runs=") )
+		{
+			runs = atoi(optionValue(argc, argv, "-ub-runs="));
+		}
+
+		auto t_start = chrono::high_resolution_clock::now();
+
+		heuristicColors = heuristic_coloring(graph, runs, heuristicColor);
+
+		auto t_end = chrono::high_resolution_clock::now();
+		elaspedTimeMs = std::chrono::duration<double, std::milli>(t_end-t_start).count();
+		printf("c | Upper bound: %u colors (DSATUR + %u greedy runs) in %4.5f ms\n",heuristicColors,runs,elaspedTimeMs);
+
+		/* The assignment encoding only needs the colors of the heuristic. */
+		if ( encodingOptions.kind == ENCODING_ASSIGNMENT && encodingOptions.nbColors == 0 )
+		{
+			encodingOptions.nbColors = heuristicColors;
+		}
+	}
+
+	/* -ternary-watches: clauses of size 3 are propagated from their own watch lists (Solver::watchesTer). */
+	if ( hasOption(argc, argv, "-ternary-watches") )
+	{
+		glucose.useTernaryWatches = true;
+	}
+
+	/* -bench-propagation: same encoding and budget with and without the ternary watches, then exit. */
+	if ( hasOption(argc, argv, "-bench-propagation") )
+	{
+		int64_t conflictBudget = 100000;
+
+		if ( optionValue(argc, argv, "-bench-conflicts=") )
+		{
+			conflictBudget = atoll(optionValue(argc, argv, "-bench-conflicts="));
+		}
+
+		double generic = benchPropagation(&graph,encodingOptions,false,conflictBudget);
+		double ternary = benchPropagation(&graph,encodingOptions,true,conflictBudget);
+
+		printf("c | Propagations/s: generic %.0f, ternary %.0f (x%.2f)\n",generic,ternary,generic > 0 ? ternary / generic : 0.0);
+		exit(0);
+	}
+
+	/* The triangles only give part of the transitivity, the rest is checked on the models: the WCNF of -maxsat needs all of it. */
+	if ( hasOption(argc, argv, "-maxsat") )
+	{
+		graph.setOfTriplets.clear();
+	}
+
+	SAT_Encoding sat_encoding(&graph,&glucose,encodingOptions);	
 
 	cout << "c | #Variables:  " << glucose.nVars() << endl;
 	cout << "c | #Clauses:    " << glucose.nClauses() << endl;
@@ -90,16 +348,19 @@ int main(int argc, char** argv)
 
 	cout << "c | Start solving.                                                                                        | " << endl;
 
-	unsigned int k = sat_encoding.getNbNodes();
+	unsigned int k = sat_encoding.getMaxColors();
 
-	if ( (argc > 1 && !strcmp("-maxsat", argv[1])) || (argc > 2 && !strcmp("-maxsat", argv[2])) )
+	vec<Lit> color_lits;
+	sat_encoding.colorLiterals(color_lits);
+
+	if ( hasOption(argc, argv, "-maxsat") )
 	{
 		FILE* file = stdout;		
 		
 		unsigned int size_clauses = glucose.clauses.size();
 		unsigned int size_trail = glucose.trail.size();
 
-		fprintf(file,"p wcnf %d %d %d\n", glucose.nVars(),size_clauses+size_trail+k,k);
+		fprintf(file,"p wcnf %d %d %d\n", glucose.nVars(),size_clauses+size_trail+color_lits.size(),k);
 		
 		for (unsigned int i = 0 ; i < size_clauses; ++i)
 		{
@@ -118,59 +379,127 @@ int main(int argc, char** argv)
 		for(unsigned int i = 0; i < size_trail; ++i) 
 			fprintf(file,"%d %d 0\n",k, myLit(glucose.trail[i]));
 
-		/* Need to maximize the number of n_i to false :) thus minimize the number of colors. */
-		for(unsigned int i = 1; i < k; i++) 
-			fprintf(file,"1 -%d 0\n",sat_encoding.n_i[i]);
+		/* Need to maximize the number of n_i (y_c) to false :) thus minimize the number of colors. */
+		for(int i = 0; i < color_lits.size(); i++) 
+			fprintf(file,"1 %d 0\n",myLit(~color_lits[i]));
 	
 		exit(0);
 	}
 
+	/* The first solve starts from the heuristic coloring, under its number of colors. */
+	if ( heuristicColors > 0 )
+	{
+		if ( sat_encoding.setPhases(&glucose, heuristicColor) ) k = std::min(k, heuristicColors);
+		else cout << "c | The encoding cannot express the heuristic coloring, starting from k = " << k << endl;
+	}
+
 	ModelChecker model(&glucose,&graph,&sat_encoding,k);
-	openwbo::Adder encoder;	
 
-	vec<Lit> n_is;
-	vec<uint64_t> coeffs;
-	for(unsigned int i = 0; i < sat_encoding.n_i.size(); i++) 
+	/* -search=: how the bounds are probed, -budget=: the first conflict budget of the progressive search. */
+	SearchStrategy strategy = SEARCH_LINEAR;
+
+	if ( optionValue(argc, argv, "-search=") )
+	{
+		strategy = search_from_name(optionValue(argc, argv, "-search="));
+	}
+
+	int64_t budget = 10000;
+
+	if ( optionValue(argc, argv, "-budget=") )
 	{
-		n_is.push(Glucose::mkLit(sat_encoding.n_i[i],true));	
-		coeffs.push(1);
+		budget = atoll(optionValue(argc, argv, "-budget="));
 	}
 
+	/* The number of colors of copy_model (0 before the first model), and the fewest colors still possible. */
+	unsigned int best = 0;
+	unsigned int lower = std::max(1u, (unsigned int)clique.size());
+
+	/* The time spent in the solver, per answer. */
+	double timeSat = 0, timeUnsat = 0, timeUnknown = 0;
+	unsigned int nbSat = 0, nbUnsat = 0, nbUnknown = 0;
+
+	/* Progressive search: whether the next probe is at the lower bound rather than just below the best coloring. */
+	bool lowerSide = false;
 
 	try {
 
 		vec<Lit> assumptions;		
-		encoder.encodeInc(&glucose, n_is, coeffs, k, assumptions);
+		sat_encoding.boundColors(&glucose, k, assumptions);
 
-		while(res && k > 0)
+		while(k > 0)
 		{	
+			if(strategy == SEARCH_PROGRESSIVE) glucose.setConfBudget(budget);
+			else glucose.budgetOff();
+
 			auto t_start = chrono::high_resolution_clock::now();
 
-			res = glucose.solve(assumptions);
+			Glucose::lbool answer = glucose.solveLimited(assumptions);
 
 			auto t_end = chrono::high_resolution_clock::now();		
 			elaspedTimeMs = std::chrono::duration<double, std::milli>(t_end-t_start).count();			   
-			printf("c | Solving for k = %5u : %20.5f ms | p cnf %10d %10d | Assumptions : %d \n",k,elaspedTimeMs,glucose.nVars(),glucose.nClauses(),assumptions.size());
+			printf("c | Solving for k = %5u : %20.5f ms | p cnf %10d %10d | Assumptions : %d %s\n",k,elaspedTimeMs,glucose.nVars(),glucose.nClauses(),assumptions.size(),
+				answer == l_True ? "SAT" : answer == l_False ? "UNSAT" : "UNKNOWN");
 
-			if(res)
+			if(answer == l_True)
 			{											
-				copy_model.resize(glucose.model.size());
+				timeSat += elaspedTimeMs; nbSat++;
+
+				vector<bool> current_model(glucose.model.size());
 				for(int i = 1; i < glucose.model.size(); i++)
 				{
-					copy_model[i] = (glucose.model[i] == l_True);
+					current_model[i] = (glucose.model[i] == l_True);
 				}				
 
-				model.setSolver(copy_model);
+				model.setSolver(current_model);
 
-				unsigned int new_k = model.obtainNbColors();
+				/* Not a coloring yet: solve again for the same k with the violated transitivity clauses. */
+				if(sat_encoding.isLazy() && model.addTransitivityLemmas() > 0) continue;
 
-				if(new_k < k) k = new_k;
-				else k--;
+				copy_model.swap(current_model);
 
-				encoder.updateInc(&glucose,k,assumptions);				
+				best = model.obtainNbColors();
+				lowerSide = false;
 				
 				// model.toDOT_color(stderr);		
 			} 		
+			else if(answer == l_False)
+			{
+				timeUnsat += elaspedTimeMs; nbUnsat++;
+
+				lower = k + 1;
+			}
+			else
+			{
+				timeUnknown += elaspedTimeMs; nbUnknown++;
+
+				/* Out of budget: after the probe below the best coloring try the lower bound, after both retry with twice the budget. */
+				if(best == 0 || lowerSide) budget *= 2;
+				lowerSide = best != 0 && !lowerSide;
+			}
+
+			/* Without any model, the first bound is already too low. */
+			if(best == 0 && answer == l_False) break;
+
+			if(best != 0 && best <= lower)
+			{
+				/* No coloring uses fewer colors than the clique has vertices. */
+				if(best < clique.size()) fprintf(stderr, "ERROR! %u colors found for a clique of %u vertices\n", best, (unsigned int)clique.size()), exit(1);
+				if(best == clique.size()) printf("c | Lower bound reached: %u colors\n",best);
+				break;
+			}
+
+			if(best == 0) continue;
+
+			unsigned int next = best - 1;
+
+			if(strategy == SEARCH_BINARY) next = lower + (best - 1 - lower) / 2;
+			if(strategy == SEARCH_PROGRESSIVE && lowerSide) next = lower;
+
+			if(next != k || answer != l_Undef)
+			{
+				k = next;
+				sat_encoding.boundColors(&glucose,k,assumptions);
+			}
 		}
 	} 
 	catch (const Glucose::OutOfMemoryException & ex) 
@@ -182,14 +511,31 @@ int main(int argc, char** argv)
 
 	glucose.printIncrementalStats();
 
-	cout << "s SATISFIABLE" << endl;
-	model.setSolver(copy_model);
-	k = model.obtainNbColors();			
-	cout << "o " << k << " colors" << endl;
-	if(toPrintModel)
+	printf("c | Search %s: %u SAT in %.5f ms, %u UNSAT in %.5f ms, %u unknown in %.5f ms\n",search_name(strategy),nbSat,timeSat,nbUnsat,timeUnsat,nbUnknown,timeUnknown);
+
+	if(sat_encoding.isLazy()) printf("c | Transitivity lemmas   : %llu\n",(unsigned long long)model.nbLemmas);
+
+	if(best == 0)
 	{
-		model.toDOT_color(stderr);
-		cerr << endl;
+		/* No model to decode: the first bound is proven too low, or the search stopped before any answer. */
+		if(lower > k)
+		{
+			cout << "s UNSATISFIABLE" << endl;
+			printf("c | No coloring with at most %u colors\n",k);
+		}
+		else cout << "s UNKNOWN" << endl;
+	}
+	else
+	{
+		cout << "s SATISFIABLE" << endl;
+		model.setSolver(copy_model);
+		k = model.obtainNbColors();			
+		cout << "o " << k << " colors" << endl;
+		if(toPrintModel)
+		{
+			model.toDOT_color(stderr);
+			cerr << endl;
+		}
 	}
 	
 	// cout << "c v ";
@@ -29,6 +29,9 @@
 #include <iostream>
 #include "SAT_Encoding.h"
 #include "ModelChecker.h"
+#include "Decomposition.h"
+#include "Coloring.h"
+#include "LowerBound.h"
 #include "SolverTypes.h"
 #include <algorithm>
 #include <chrono>
@@ -24,29 +24,13 @@
 
 		fprintf(file,"graph g {\n");
 
-		vector<unsigned int> same_colors;
+		vector<unsigned int> color;
+		encoding->decode(model, color);
 
-		unsigned int color_index = -1;
-
-		for(unsigned int i = 0; i < graph->nbVertices; ++i)
-		{
-			if(std::find(same_colors.begin(), same_colors.end(), i) == same_colors.end()) {
-				color_index++;
-				fprintf(file,"%d [style=filled, fillcolor=%s]\n",i+1,colors[color_index].c_str());
-			}
-
-			for(unsigned int j = i+1; j < graph->nbVertices; ++j)
-			{
-				if(model[encoding->s_ij[i][j]]) 
-				{
-					fprintf(file,"%d [style=filled, fillcolor=%s]\n",j+1,colors[color_index].c_str());	
-					same_colors.push_back(j);
-				}
-			}	
-
-		}
+		for(unsigned int v = 0; v < graph->nbVertices; ++v)
+			fprintf(file,"%d [style=filled, fillcolor=%s]\n",v+1,colors[color[v] % colors.size()].c_str());
     		
-		for(Edge* e : graph->edges)  e->toDOT(file); 
+		graph->toDOT_edges(file);
 
     	fprintf(file,"}");
 	}
@@ -54,24 +38,68 @@
 
 	unsigned int ModelChecker::obtainNbColors()
 	{
-		vector<unsigned int> same_colors;
+		vector<unsigned int> color;
+		return encoding->decode(model, color);
+	}
 
-		unsigned int nbColors = graph->nbVertices;
 
-		for(unsigned int i = 0; i < graph->nbVertices; ++i)
+	unsigned int ModelChecker::addTransitivityLemmas()
+	{
+		const PairIndex& pairs = encoding->s_ij;
+		const unsigned int none = graph->nbVertices;
+
+		/* parent[j] is the first earlier vertex the model puts in the same color as j: the one decode() copies the color of. */
+		vector<unsigned int> parent(graph->nbVertices, none);
+		vector<unsigned int> color(graph->nbVertices);
+
+		for(unsigned int j = 0; j < graph->nbVertices; ++j)
 		{
-			if(std::find(same_colors.begin(), same_colors.end(), i) != same_colors.end()) {
-				nbColors--;
+			for(uint64_t t = 0; t < pairs.nbLower(j); ++t)
+			{
+				if(model[pairs.variable(j,t)]) { parent[j] = pairs.lower(j,t); break; }
 			}
+			color[j] = (parent[j] == none) ? j : color[parent[j]];
+		}
+
+		unsigned int added = 0;
+		vector<bool> done(graph->nbVertices, false);
+		Glucose::vec<Glucose::Lit> clause;
+
+		/* s_ij & s_ik --> s_jk. Each clause added is violated by the model. */
+		auto addLemma = [&](unsigned int i, unsigned int j, unsigned int k)
+		{
+			clause.clear();
+			clause.push(Glucose::mkLit(pairs.find(i,j),true));
+			clause.push(Glucose::mkLit(pairs.find(i,k),true));
+			clause.push(Glucose::mkLit(pairs.find(j,k),false));
 
-			for(unsigned int j = i+1; j < graph->nbVertices; ++j)
+			solver->addClause(clause);
+			added++;
+		};
+
+		/* The relation needs not be transitive as long as the decoded coloring is proper: only the two
+		   ends of a monochromatic edge get a lemma, on their parent link or on their common parent. */
+		for(unsigned int u = 1; u <= graph->nbVertices; ++u)
+		{
+			for(unsigned int w : graph->neighbors(u))
 			{
-				if(model[encoding->s_ij[i][j]])  
+				if(w < u || color[u-1] != color[w-1]) continue;
+
+				bool chained = false;
+				for(unsigned int x : {u-1, w-1})
 				{
-					same_colors.push_back(j);
+					unsigned int p = parent[x];
+					if(p == none || parent[p] == none) continue;
+
+					chained = true;
+					if(!done[x]) { addLemma(p, x, parent[p]); done[x] = true; }
 				}
-			}	
+
+				/* Both hang directly from the same vertex. */
+				if(!chained) addLemma(parent[u-1], u-1, w-1);
+			}
 		}
-    		
-		return nbColors;
-	}
\ No newline at end of file
+
+		nbLemmas += added;
+		return added;
+	}
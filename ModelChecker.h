@@ -82,6 +82,12 @@ public:
 
 	unsigned int obtainNbColors();
 
+	/* Adds to the solver transitivity clauses violated by the model (pairwise encoding), only where the
+	   decoded coloring is not proper; returns how many were added: 0 means the model is a coloring. */
+	unsigned int addTransitivityLemmas();
+
+	uint64_t nbLemmas = 0;
+
 };
 
 #endif
\ No newline at end of file
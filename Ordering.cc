@@ -0,0 +1,673 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "Ordering.h"
+#include "Graph.h"
+#include "BitOps.h"
+#include "mtl/Heap.h"
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+namespace msp {
+
+  OrderingHeuristic ordering_from_name(const char* name)
+  {
+    if (!strcmp(name, "min-fill"))        return ORDER_MIN_FILL;
+    if (!strcmp(name, "min-fill-degree")) return ORDER_MIN_FILL_DEGREE;
+    if (!strcmp(name, "min-degree"))      return ORDER_MIN_DEGREE;
+    if (!strcmp(name, "mcs-m"))           return ORDER_MCS_M;
+    if (!strcmp(name, "lex-m"))           return ORDER_LEX_M;
+    if (!strcmp(name, "portfolio"))       return ORDER_PORTFOLIO;
+
+    fprintf(stderr, "ERROR! Unknown ordering heuristic: %s (min-fill, min-fill-degree, min-degree, mcs-m, lex-m or portfolio)\n", name), exit(1);
+  }
+
+  const char* ordering_name(OrderingHeuristic heuristic)
+  {
+    switch (heuristic)
+    {
+      case ORDER_MIN_FILL:        return "min-fill";
+      case ORDER_MIN_FILL_DEGREE: return "min-fill-degree";
+      case ORDER_MIN_DEGREE:      return "min-degree";
+      case ORDER_MCS_M:           return "mcs-m";
+      case ORDER_LEX_M:           return "lex-m";
+      case ORDER_PORTFOLIO:       return "portfolio";
+    }
+    return "unknown";
+  }
+
+  void elimination_order(const Graph& g, const TriangulationOptions& options, std::vector<unsigned int>& order, unsigned int seed)
+  {
+    switch (options.heuristic)
+    {
+      case ORDER_MIN_FILL:        min_fill_order(g, false, order, seed); break;
+      case ORDER_MIN_FILL_DEGREE: min_fill_order(g, true, order, seed);  break;
+      case ORDER_MIN_DEGREE:      min_degree_order(g, order, seed);      break;
+      case ORDER_MCS_M:           mcs_m_order(g, false, order, seed);    break;
+      case ORDER_LEX_M:           mcs_m_order(g, true, order, seed);     break;
+      case ORDER_PORTFOLIO:       portfolio_order(g, options, order);    break;
+    }
+  }
+
+  /** The rank of each vertex used to break the ties: its id for seed 0, a random permutation otherwise. */
+  static void tie_break_ranks(unsigned int n, unsigned int seed, std::vector<unsigned int>& rank)
+  {
+    rank.resize(n+1);
+    for (unsigned int v = 0; v <= n; v++) rank[v] = v;
+
+    if (seed != 0)
+    {
+      std::mt19937 generator(seed);
+      std::shuffle(rank.begin()+1, rank.end(), generator);
+    }
+  }
+
+  /**
+   * The graph of the elimination game: eliminating a vertex makes its remaining neighbors a clique, then removes it.
+   * The neighbors are kept in unsorted lists. When the graph has the adjacency bit-matrix, a copy of the rows is kept
+   * up to date as well, so that the adjacency tests and the common neighborhoods go through the kernels of BitOps.h.
+   */
+  class EliminationGraph
+  {
+  private:
+
+    unsigned int n;
+
+    size_t words; /*< 0 without the bit-matrix */
+
+    std::vector<std::vector<unsigned int>> adj;
+
+    std::vector<uint64_t> bits;
+
+    /** marks of the vertices, valid when equal to time (mark() for the caller, seen for common()) */
+    std::vector<unsigned int> marks, seen;
+
+    unsigned int time, seenTime;
+
+    inline uint64_t* row(unsigned int v) { return &bits[(size_t)v * words]; }
+
+  public:
+
+    explicit EliminationGraph(const Graph& g) : n(g.getNbNodes()), words(g.adjacency.isDense() ? g.adjacency.nbWords() : 0),
+                                                adj(n+1), marks(n+1, 0), seen(n+1, 0), time(0), seenTime(0)
+    {
+      if (words) bits.assign((size_t)(n+1) * words, 0);
+
+      for (unsigned int v = 1; v <= n; v++)
+        for (unsigned int x: g.neighbors(v))
+          if (x != v)
+          {
+            adj[v].push_back(x);
+            if (words) row(v)[x >> 6] |= (uint64_t)1 << (x & 63);
+          }
+    }
+
+    inline unsigned int degree(unsigned int v) const { return adj[v].size(); }
+
+    inline const std::vector<unsigned int>& neighbors(unsigned int v) const { return adj[v]; }
+
+    /** Marks the neighbors of v, for the adjacency tests of adjacent(v,y) until the next call. */
+    inline void mark(unsigned int v)
+    {
+      if (words) return;
+      if (++time == 0) { std::fill(marks.begin(), marks.end(), 0); time = 1; }
+      for (unsigned int x: adj[v]) marks[x] = time;
+    }
+
+    /** Returns true if x -- y is an edge, x being the vertex of the last call to mark(). */
+    inline bool adjacent(unsigned int x, unsigned int y)
+    {
+      return words ? (row(x)[y >> 6] >> (y & 63)) & 1 : marks[y] == time;
+    }
+
+    /** Returns the number of common neighbors of x and y, and lists them in out if it is not NULL. */
+    unsigned int common(unsigned int x, unsigned int y, std::vector<unsigned int>* out)
+    {
+      if (out) out->clear();
+
+      if (words)
+      {
+        if (!out) return popcount_and(row(x), row(y), words);
+
+        const uint64_t* a = row(x);
+        const uint64_t* b = row(y);
+
+        for (size_t w = 0; w < words; w++)
+          for (uint64_t m = a[w] & b[w]; m; m &= m - 1) out->push_back((w << 6) + __builtin_ctzll(m));
+
+        return out->size();
+      }
+
+      if (++seenTime == 0) { std::fill(seen.begin(), seen.end(), 0); seenTime = 1; }
+
+      const std::vector<unsigned int>& small = adj[x].size() < adj[y].size() ? adj[x] : adj[y];
+      const std::vector<unsigned int>& large = adj[x].size() < adj[y].size() ? adj[y] : adj[x];
+      unsigned int count = 0;
+
+      for (unsigned int z: small) seen[z] = seenTime;
+      for (unsigned int z: large) if (seen[z] == seenTime) { count++; if (out) out->push_back(z); }
+
+      return count;
+    }
+
+    /** Returns the number of pairs of neighbors of v which are not adjacent. */
+    uint64_t fill_in(unsigned int v)
+    {
+      uint64_t d = adj[v].size(), connected = 0;
+
+      // each adjacent pair is counted from both ends
+      if (!words) mark(v);
+      for (unsigned int x: adj[v])
+        if (words) connected += popcount_and(row(v), row(x), words);
+        else for (unsigned int y: adj[x]) if (marks[y] == time) connected++;
+
+      return d*(d-1)/2 - connected/2;
+    }
+
+    /** Adds the edge x -- y, which must be missing. */
+    inline void add_edge(unsigned int x, unsigned int y)
+    {
+      adj[x].push_back(y);
+      adj[y].push_back(x);
+
+      if (words)
+      {
+        row(x)[y >> 6] |= (uint64_t)1 << (y & 63);
+        row(y)[x >> 6] |= (uint64_t)1 << (x & 63);
+      }
+    }
+
+    /** Calls fill(x,y) then adds the edge, for each missing edge x -- y among the neighbors of u. */
+    template <class Fill>
+    void make_clique(unsigned int u, Fill fill)
+    {
+      const std::vector<unsigned int>& l = adj[u];
+
+      for (size_t i = 0; i < l.size(); i++)
+      {
+        unsigned int x = l[i];
+        mark(x);
+
+        // the edges added below never involve u: l stays as it is
+        for (size_t j = i+1; j < l.size(); j++)
+          if (!adjacent(x, l[j])) { fill(x, l[j]); add_edge(x, l[j]); }
+      }
+    }
+
+    /** Removes u and its edges. */
+    void remove(unsigned int u)
+    {
+      for (unsigned int x: adj[u])
+      {
+        std::vector<unsigned int>& l = adj[x];
+        for (size_t i = 0; i < l.size(); i++)
+          if (l[i] == u) { l[i] = l.back(); l.pop_back(); break; }
+
+        if (words) row(x)[u >> 6] &= ~((uint64_t)1 << (u & 63));
+      }
+
+      std::vector<unsigned int>().swap(adj[u]);
+    }
+  };
+
+  /** Orders the vertices of the min-fill heap: smallest fill-in first, then (optionally) smallest degree, then smallest rank. */
+  struct FillOrder
+  {
+    const std::vector<uint64_t>* score;
+    const std::vector<unsigned int>* degree; // NULL if the ties are not broken by degree
+    const std::vector<unsigned int>* rank;
+
+    bool operator()(int a, int b) const
+    {
+      if ((*score)[a] != (*score)[b]) return (*score)[a] < (*score)[b];
+      if (degree != NULL && (*degree)[a] != (*degree)[b]) return (*degree)[a] < (*degree)[b];
+      return (*rank)[a] < (*rank)[b];
+    }
+  };
+
+  void min_fill_order(const Graph& g, bool degreeTieBreak, std::vector<unsigned int>& order, unsigned int seed)
+  {
+    unsigned int n = g.getNbNodes();
+
+    std::vector<unsigned int> rank;
+    tie_break_ranks(n, seed, rank);
+
+    EliminationGraph eg(g);
+
+    std::vector<uint64_t> score(n+1, 0);
+    std::vector<unsigned int> degree(n+1, 0), shared, touched;
+
+    // the changes of a step are summed in delta and applied at its end: the heap moves each vertex once
+    std::vector<int64_t> delta(n+1, 0);
+    std::vector<char> isTouched(n+1, false);
+
+    auto change = [&](unsigned int v, int64_t d)
+    {
+      if (!isTouched[v]) { isTouched[v] = true; touched.push_back(v); }
+      delta[v] += d;
+    };
+
+    for (unsigned int v = 1; v <= n; v++)
+    {
+      score[v] = eg.fill_in(v);
+      degree[v] = eg.degree(v);
+    }
+
+    FillOrder lt = { &score, degreeTieBreak ? &degree : NULL, &rank };
+    Glucose::Heap<FillOrder> heap(lt);
+
+    for (unsigned int v = 1; v <= n; v++) heap.insert(v);
+
+    order.clear();
+
+    while (!heap.empty())
+    {
+      unsigned int u = heap.removeMin();
+      order.push_back(u);
+      touched.clear();
+
+      // the fill edge x -- y joins the pairs of x and y, and the pair {x,y} of their common neighbors is no longer missing
+      eg.make_clique(u, [&](unsigned int x, unsigned int y)
+      {
+        unsigned int c = eg.common(x, y, &shared);
+
+        for (unsigned int w: shared)
+          if (w != u) change(w, -1);
+
+        change(x, (int64_t)eg.degree(x) - c);
+        change(y, (int64_t)eg.degree(y) - c);
+      });
+
+      // the neighbors of u now form a clique: v loses the pairs {u,z} where z is a neighbor of v outside of it
+      unsigned int size = eg.degree(u);
+
+      for (unsigned int v: eg.neighbors(u)) change(v, -(int64_t)(eg.degree(v) - size));
+
+      eg.remove(u);
+
+      for (unsigned int v: touched)
+      {
+        score[v] += delta[v];
+        degree[v] = eg.degree(v);
+        delta[v] = 0;
+        isTouched[v] = false;
+        heap.update(v);
+      }
+    }
+  }
+
+  void min_degree_order(const Graph& g, std::vector<unsigned int>& order, unsigned int seed)
+  {
+    unsigned int n = g.getNbNodes();
+
+    EliminationGraph eg(g);
+
+    // bucket d is a doubly-linked list of the remaining vertices of degree d in the filled graph, 0 ends a list
+    std::vector<unsigned int> head(n+1, 0), next(n+1, 0), prev(n+1, 0), degree(n+1, 0), around;
+
+    std::vector<unsigned int> rank, byRank(n+1, 0);
+    tie_break_ranks(n, seed, rank);
+    for (unsigned int v = 1; v <= n; v++) byRank[rank[v]] = v;
+
+    unsigned int minDegree = 0;
+
+    auto unlink = [&](unsigned int v)
+    {
+      if (prev[v]) next[prev[v]] = next[v]; else head[degree[v]] = next[v];
+      if (next[v]) prev[next[v]] = prev[v];
+    };
+
+    auto link = [&](unsigned int v)
+    {
+      next[v] = head[degree[v]];
+      prev[v] = 0;
+      if (head[degree[v]]) prev[head[degree[v]]] = v;
+      head[degree[v]] = v;
+      if (degree[v] < minDegree) minDegree = degree[v];
+    };
+
+    // inserted by decreasing rank, so that each bucket starts with its smallest rank
+    for (unsigned int r = n; r >= 1; r--) { degree[byRank[r]] = eg.degree(byRank[r]); link(byRank[r]); }
+
+    order.clear();
+
+    while (order.size() < n)
+    {
+      while (head[minDegree] == 0) minDegree++;
+
+      unsigned int u = head[minDegree];
+      unlink(u);
+      order.push_back(u);
+
+      // the neighbors of u become a clique, their degrees are read again once u is gone
+      around = eg.neighbors(u);
+      eg.make_clique(u, [](unsigned int, unsigned int) { });
+      eg.remove(u);
+
+      for (unsigned int v: around)
+      {
+        unlink(v);
+        degree[v] = eg.degree(v);
+        link(v);
+      }
+    }
+  }
+
+  void degeneracy_order(const Graph& g, std::vector<unsigned int>& order, unsigned int seed)
+  {
+    unsigned int n = g.getNbNodes();
+
+    // bucket d is a doubly-linked list of the remaining vertices of degree d, 0 ends a list
+    std::vector<unsigned int> head(n+1, 0), next(n+1, 0), prev(n+1, 0), degree(n+1, 0);
+    std::vector<char> eliminated(n+1, false);
+
+    std::vector<unsigned int> rank, byRank(n+1, 0);
+    tie_break_ranks(n, seed, rank);
+    for (unsigned int v = 1; v <= n; v++) byRank[rank[v]] = v;
+
+    // inserted by decreasing rank, so that each bucket starts with its smallest rank
+    for (unsigned int r = n; r >= 1; r--)
+    {
+      unsigned int v = byRank[r];
+
+      for (unsigned int x: g.neighbors(v)) if (x != v) degree[v]++;
+
+      next[v] = head[degree[v]];
+      prev[v] = 0;
+      if (head[degree[v]]) prev[head[degree[v]]] = v;
+      head[degree[v]] = v;
+    }
+
+    unsigned int minDegree = 0;
+
+    order.clear();
+
+    while (order.size() < n)
+    {
+      while (head[minDegree] == 0) minDegree++;
+
+      unsigned int u = head[minDegree];
+
+      head[minDegree] = next[u];
+      if (next[u]) prev[next[u]] = 0;
+
+      order.push_back(u);
+      eliminated[u] = true;
+
+      // the remaining neighbors move down one bucket
+      for (unsigned int v: g.neighbors(u))
+      {
+        if (eliminated[v]) continue;
+
+        unsigned int d = degree[v]--;
+
+        if (prev[v]) next[prev[v]] = next[v]; else head[d] = next[v];
+        if (next[v]) prev[next[v]] = prev[v];
+
+        next[v] = head[d-1];
+        prev[v] = 0;
+        if (head[d-1]) prev[head[d-1]] = v;
+        head[d-1] = v;
+
+        if (d-1 < minDegree) minDegree = d-1;
+      }
+    }
+  }
+
+  void mcs_m_order(const Graph& g, bool lexicographic, std::vector<unsigned int>& order, unsigned int seed)
+  {
+    unsigned int n = g.getNbNodes();
+
+    std::vector<unsigned int> rank, byRank(n+1, 0);
+    tie_break_ranks(n, seed, rank);
+    for (unsigned int v = 1; v <= n; v++) byRank[rank[v]] = v;
+
+    // LEX-M labels are doubled ranks: +1 stands for the +1/2 of the original algorithm
+    std::vector<unsigned int> label(n+1, 0);
+    std::vector<unsigned int> reached(n+1, 0), raised, heads;
+    std::vector<char> numbered(n+1, false);
+    std::vector<std::vector<unsigned int>> reach(2*n+2);
+
+    // bucket l is a doubly-linked list of the unnumbered vertices of label l, 0 ends a list
+    std::vector<unsigned int> head(2*n+2, 0), next(n+1, 0), prev(n+1, 0);
+    unsigned int maxLabel = 0;
+
+    auto unlink = [&](unsigned int v)
+    {
+      if (prev[v]) next[prev[v]] = next[v]; else head[label[v]] = next[v];
+      if (next[v]) prev[next[v]] = prev[v];
+    };
+
+    auto link = [&](unsigned int v)
+    {
+      next[v] = head[label[v]];
+      prev[v] = 0;
+      if (head[label[v]]) prev[head[label[v]]] = v;
+      head[label[v]] = v;
+      if (label[v] > maxLabel) maxLabel = label[v];
+    };
+
+    // inserted by decreasing rank, so that the bucket starts with the smallest rank
+    for (unsigned int r = n; r >= 1; r--) link(byRank[r]);
+
+    order.assign(n, 0);
+
+    for (unsigned int i = n; i >= 1; i--)
+    {
+      // unnumbered vertex of largest label
+      while (head[maxLabel] == 0) maxLabel--;
+
+      unsigned int v = head[maxLabel];
+      unlink(v);
+
+      order[i-1] = v;
+      numbered[v] = true;
+      reached[v] = i;
+      raised.clear();
+
+      // the vertices reached from v through unnumbered vertices of label smaller than their own are raised
+      for (unsigned int w: g.neighbors(v))
+        if (!numbered[w] && reached[w] != i)
+        {
+          reached[w] = i;
+          reach[label[w]].push_back(w);
+          raised.push_back(w);
+        }
+
+      for (unsigned int j = 0; j <= maxLabel; j++)
+        while (!reach[j].empty())
+        {
+          unsigned int w = reach[j].back();
+          reach[j].pop_back();
+
+          for (unsigned int z: g.neighbors(w))
+            if (!numbered[z] && reached[z] != i)
+            {
+              reached[z] = i;
+
+              if (label[z] > j) { reach[label[z]].push_back(z); raised.push_back(z); }
+              else reach[j].push_back(z);
+            }
+        }
+
+      for (unsigned int w: raised) { unlink(w); label[w]++; link(w); }
+
+      // without any raise, the labels are still 0, 2, 4, ...
+      if (lexicographic && i > 1 && !raised.empty())
+      {
+        // renumber the distinct labels 0, 2, 4, ... keeping their order: the buckets move as a whole
+        heads.clear();
+        for (unsigned int l = 0; l <= maxLabel; l++)
+          if (head[l]) { heads.push_back(head[l]); head[l] = 0; }
+
+        for (unsigned int b = 0; b < heads.size(); b++)
+        {
+          head[2*b] = heads[b];
+          for (unsigned int w = heads[b]; w != 0; w = next[w]) label[w] = 2*b;
+        }
+
+        maxLabel = heads.empty() ? 0 : 2*(heads.size()-1);
+      }
+    }
+  }
+
+  /**
+   * The elimination game along the elimination tree: the later neighbors of u in the filled graph are its own
+   * and those of its children, then visit(u, later[u]) is called. Unless keep is set, the list of a child is
+   * released once its parent has it.
+   */
+  template <class Visit>
+  static void eliminate(const Graph& g, const std::vector<unsigned int>& order, std::vector<std::vector<unsigned int>>& later, bool keep, Visit visit)
+  {
+    unsigned int n = g.getNbNodes();
+
+    std::vector<unsigned int> position(n+1, 0), stamp(n+1, 0);
+    for (unsigned int i = 0; i < order.size(); i++) position[order[i]] = i;
+
+    // children of each vertex in the elimination tree: its parent is its earliest later neighbor
+    std::vector<unsigned int> child(n+1, 0), sibling(n+1, 0);
+
+    later.assign(n+1, std::vector<unsigned int>());
+
+    for (unsigned int u: order)
+    {
+      std::vector<unsigned int>& l = later[u];
+      stamp[u] = u;
+
+      for (unsigned int x: g.neighbors(u))
+        if (position[x] > position[u] && stamp[x] != u) { stamp[x] = u; l.push_back(x); }
+
+      for (unsigned int w = child[u]; w != 0; w = sibling[w])
+      {
+        for (unsigned int x: later[w])
+          if (stamp[x] != u) { stamp[x] = u; l.push_back(x); }
+
+        if (!keep) std::vector<unsigned int>().swap(later[w]);
+      }
+
+      visit(u, l);
+
+      if (l.empty()) continue;
+
+      unsigned int parent = l[0];
+      for (unsigned int x: l) if (position[x] < position[parent]) parent = x;
+
+      sibling[u] = child[parent];
+      child[parent] = u;
+    }
+  }
+
+  void filled_graph(const Graph& g, const std::vector<unsigned int>& order, std::vector<std::vector<unsigned int>>& later)
+  {
+    eliminate(g, order, later, true, [](unsigned int, const std::vector<unsigned int>&) { });
+  }
+
+  void order_cost(const Graph& g, const std::vector<unsigned int>& order, uint64_t& triangles, unsigned int& maxClique)
+  {
+    std::vector<std::vector<unsigned int>> later;
+
+    triangles = 0;
+    maxClique = 0;
+
+    // only the lists not yet passed to a parent are kept: the filled graph is never stored as a whole
+    eliminate(g, order, later, false, [&](unsigned int, const std::vector<unsigned int>& l)
+    {
+      uint64_t size = l.size();
+
+      triangles += size*(size-1)/2;
+      if (size+1 > maxClique) maxClique = size+1;
+    });
+  }
+
+  void portfolio_order(const Graph& g, const TriangulationOptions& options, std::vector<unsigned int>& order)
+  {
+    static const OrderingHeuristic heuristics[] = { ORDER_MIN_FILL, ORDER_MIN_DEGREE, ORDER_MCS_M, ORDER_MIN_FILL_DEGREE, ORDER_LEX_M };
+    static const unsigned int nbHeuristics = sizeof(heuristics) / sizeof(heuristics[0]);
+
+    unsigned int nbRuns = std::max(1u, options.portfolioRuns);
+    unsigned int nbThreads = options.portfolioThreads;
+
+    if (nbThreads == 0) nbThreads = std::thread::hardware_concurrency();
+    if (nbThreads == 0) nbThreads = 1;
+    if (nbThreads > nbRuns) nbThreads = nbRuns;
+
+    auto t_start = std::chrono::steady_clock::now();
+    auto deadline = t_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.portfolioTime));
+
+    std::atomic<unsigned int> nextRun(0), nbDone(0);
+    std::mutex lock;
+
+    uint64_t bestTriangles = 0;
+    unsigned int bestClique = 0, bestRun = 0;
+    bool found = false;
+
+    auto worker = [&]()
+    {
+      std::vector<unsigned int> candidate;
+
+      for (unsigned int run = nextRun++; run < nbRuns; run = nextRun++)
+      {
+        if (run > 0 && std::chrono::steady_clock::now() >= deadline) break;
+
+        TriangulationOptions single = options;
+        single.heuristic = heuristics[run % nbHeuristics];
+
+        elimination_order(g, single, candidate, run / nbHeuristics);
+        nbDone++;
+
+        uint64_t triangles;
+        unsigned int clique;
+        order_cost(g, candidate, triangles, clique);
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        bool better = !found
+          || ( options.minimizeClique && (clique < bestClique || (clique == bestClique && triangles < bestTriangles)))
+          || (!options.minimizeClique && (triangles < bestTriangles || (triangles == bestTriangles && clique < bestClique)))
+          || (triangles == bestTriangles && clique == bestClique && run < bestRun);
+
+        if (better)
+        {
+          found = true;
+          bestTriangles = triangles;
+          bestClique = clique;
+          bestRun = run;
+          order.swap(candidate);
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < nbThreads; t++) threads.push_back(std::thread(worker));
+    worker();
+    for (auto& t: threads) t.join();
+
+    double elaspedTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t_start).count();
+
+    printf("c | Portfolio: %u runs on %u threads in %4.5f ms, best: %s (seed %u), %llu triangles, max clique %u\n",
+           nbDone.load(), nbThreads, elaspedTimeMs, ordering_name(heuristics[bestRun % nbHeuristics]), bestRun / nbHeuristics,
+           (unsigned long long)bestTriangles, bestClique);
+  }
+
+}
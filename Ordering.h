@@ -0,0 +1,116 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#ifndef ORDERING_H
+#define ORDERING_H
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace msp {
+
+  class Graph;
+
+  /** @brief the elimination ordering heuristics (selected by -t=<name>) */
+  enum OrderingHeuristic {
+    ORDER_MIN_FILL,        /*< fewest missing pairs among the remaining neighbors, then smallest id */
+    ORDER_MIN_FILL_DEGREE, /*< same as min-fill, the ties are broken by the smallest remaining degree */
+    ORDER_MIN_DEGREE,      /*< fewest remaining neighbors, with a bucket queue */
+    ORDER_MCS_M,           /*< maximum cardinality search for minimal triangulations */
+    ORDER_LEX_M,           /*< lexicographic search for minimal triangulations */
+    ORDER_PORTFOLIO        /*< the best of several heuristics and seeds, run in parallel */
+  };
+
+  /** @brief how the triangulation is computed (see the -t and -portfolio-* options) */
+  struct TriangulationOptions {
+    OrderingHeuristic heuristic;
+
+    unsigned int portfolioRuns;    /*< number of heuristic/seed combinations tried by the portfolio */
+    unsigned int portfolioThreads; /*< 0 means one per core */
+    double portfolioTime;          /*< no new run is started after this many seconds */
+    bool minimizeClique;           /*< keep the order with the smallest maximum clique instead of the fewest triangles */
+
+    unsigned int maxLowerBound;    /*< the triangulation is skipped if the treewidth is known to be above this (0: no limit) */
+
+    const char* cacheDir;          /*< directory of cached triangulations, keyed by the content of the graph (NULL: no cache) */
+    const char* tdInput;           /*< the order is taken from this PACE .td tree decomposition instead of a heuristic */
+
+    TriangulationOptions() : heuristic(ORDER_MIN_FILL), portfolioRuns(16), portfolioThreads(0), portfolioTime(10), minimizeClique(false), maxLowerBound(0), cacheDir(NULL), tdInput(NULL) { }
+  };
+
+  /** Returns the heuristic named by the -t option (min-fill, min-fill-degree, min-degree, mcs-m, lex-m or portfolio). */
+  OrderingHeuristic ordering_from_name(const char* name);
+
+  const char* ordering_name(OrderingHeuristic heuristic);
+
+  /**
+   * @brief Computes an elimination order of the vertices 1..n of the graph with options.heuristic.
+   *
+   * The fill-in and the degrees are counted among the vertices not eliminated yet, in the graph filled so far
+   * (the elimination game: eliminating a vertex makes its remaining neighbors a clique).
+   * The remaining ties are broken by the smallest id, or by a random rank of the vertices if a seed is given.
+   * The portfolio uses the other fields of the options (see portfolio_order).
+   *
+   * @param[out] order the vertices, in elimination order
+   */
+  void elimination_order(const Graph& g, const TriangulationOptions& options, std::vector<unsigned int>& order, unsigned int seed = 0);
+
+  /** Min-fill order, kept incrementally: eliminating u only changes the scores of its remaining neighbors and of their neighbors. */
+  void min_fill_order(const Graph& g, bool degreeTieBreak, std::vector<unsigned int>& order, unsigned int seed = 0);
+
+  /** Min-degree order in the filled graph, with a bucket queue updated after each elimination (the ties are broken arbitrarily). */
+  void min_degree_order(const Graph& g, std::vector<unsigned int>& order, unsigned int seed = 0);
+
+  /** Repeatedly removes a vertex of smallest degree in the graph itself, without fill, in O(n + m): the largest such degree is the degeneracy. */
+  void degeneracy_order(const Graph& g, std::vector<unsigned int>& order, unsigned int seed = 0);
+
+  /**
+   * MCS-M (Berry et al. 2004) or LEX-M (Rose, Tarjan and Lueker 1976) order, in O(nm).
+   *
+   * Both number the vertices from n down to 1 and raise the label of every vertex reachable
+   * through vertices of smaller label; LEX-M compares the labels lexicographically. The unnumbered
+   * vertices sit in one bucket per label: the ties go to the smallest rank at first, then to the
+   * vertex raised last.
+   */
+  void mcs_m_order(const Graph& g, bool lexicographic, std::vector<unsigned int>& order, unsigned int seed = 0);
+
+  /**
+   * @brief Plays the elimination game of the order: the later neighbors of each vertex are made pairwise adjacent.
+   *
+   * later[v] receives the neighbors of v eliminated after it in the filled graph (the chordal completion),
+   * fill edges included. They are gathered along the elimination tree, in O(n + m + fill).
+   */
+  void filled_graph(const Graph& g, const std::vector<unsigned int>& order, std::vector<std::vector<unsigned int>>& later);
+
+  /** Returns the number of triangles of the order (pairs of later neighbors in the filled graph) and its largest clique. */
+  void order_cost(const Graph& g, const std::vector<unsigned int>& order, uint64_t& triangles, unsigned int& maxClique);
+
+  /**
+   * @brief Runs options.portfolioRuns heuristic/seed combinations on several threads and keeps the best order.
+   *
+   * Every run has its own state, the graph is only read. The runs are started in order
+   * (each heuristic with seed 0, then with seed 1, ...) until the time budget is spent; the
+   * first one is always run so that there is an order to return.
+   */
+  void portfolio_order(const Graph& g, const TriangulationOptions& options, std::vector<unsigned int>& order);
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "PairIndex.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace msp {
+
+  unsigned int PairIndex::initFull(unsigned int n, unsigned int first)
+  {
+    nbVertices = n;
+    firstVar = first;
+
+    if(firstVar + size() - 1 > (uint64_t)INT_MAX)
+      fprintf(stderr, "ERROR! %u vertices need %llu pair variables, more than the solver can number (%d)\n", n, (unsigned long long)size(), INT_MAX), exit(1);
+
+    return (unsigned int)(firstVar + size()) - 1;
+  }
+
+}
@@ -0,0 +1,82 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#ifndef PAIR_INDEX_H
+#define PAIR_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace msp {
+
+  /**
+   * @brief Variable of the "same color" literal s_ij of each pair of vertices (0-based, i < j).
+   *
+   * Every pair has a variable, numbered row after row of the upper triangle, so the
+   * variable is computed and nothing is stored.
+   *
+   * The pairs of j are enumerated with nbLower(j), lower(j,t) and variable(j,t), for t < nbLower(j).
+   */
+  class PairIndex {
+
+  private:
+
+    unsigned int nbVertices;
+
+    /** @brief variable of the pair (0,1) */
+    uint64_t firstVar;
+
+  public:
+
+    PairIndex() : nbVertices(0), firstVar(0) { }
+
+    /** Gives a variable to every pair, starting at first; returns the last variable used.
+     *  Exits if the last variable does not fit in an int (about 65k vertices), the type of the solver variables. */
+    unsigned int initFull(unsigned int n, unsigned int first);
+
+    inline unsigned int getNbVertices() const { return nbVertices; }
+
+    /** Returns the number of pairs. */
+    inline uint64_t size() const
+    {
+      return (uint64_t)nbVertices * (nbVertices - 1) / 2;
+    }
+
+    /** Returns the variable s_ij, computed on 64 bits: initFull() made sure the result fits in an int. */
+    inline int find(unsigned int i, unsigned int j) const
+    {
+      if(i > j) { unsigned int tmp = i; i = j; j = tmp; }
+      uint64_t row = (uint64_t)i * (nbVertices - 1) - (uint64_t)i * (i - 1) / 2;
+      return (int)(firstVar + row + (j - i - 1));
+    }
+
+    /** Returns the number of vertices i < j, each forming a pair (i,j). */
+    inline uint64_t nbLower(unsigned int j) const { return j; }
+
+    /** Returns the t-th vertex i < j. */
+    inline unsigned int lower(unsigned int j, uint64_t t) const { return (unsigned int)t; }
+
+    /** Returns the variable of the t-th pair of j. */
+    inline unsigned int variable(unsigned int j, uint64_t t) const { return (unsigned int)find((unsigned int)t, j); }
+
+  };
+
+}
+
+#endif
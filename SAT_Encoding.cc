@@ -20,8 +20,16 @@
 
 #include "SAT_Encoding.h"
 
+	EncodingKind encoding_from_name(const char* name)
+	{
+		if (!strcmp(name, "pairwise"))   return ENCODING_PAIRWISE;
+		if (!strcmp(name, "assignment")) return ENCODING_ASSIGNMENT;
 
-	SAT_Encoding::SAT_Encoding(Graph* graph, Glucose::Solver* solver)
+		fprintf(stderr, "ERROR! Unknown encoding: %s (pairwise or assignment)\n", name), exit(1);
+	}
+
+
+	SAT_Encoding::SAT_Encoding(Graph* graph, Glucose::Solver* solver, const EncodingOptions& options)
 	{	
 		openwbo::Encoder encoder;
 		
@@ -29,42 +37,57 @@
 
 		nbNodes = graph->getNbNodes();
 
+		kind = options.kind;
+
+		/* The triangles of a triangulation only give part of the transitivity: the rest is checked on the models, as with -lazy. */
+		lazy = (options.lazy || graph->setOfTriplets.size() != 0) && kind == ENCODING_PAIRWISE && !options.native;
+
+		native = options.native && kind == ENCODING_PAIRWISE;
+
+		nbColors = nbNodes;
+
+		if(kind == ENCODING_ASSIGNMENT)
+		{
+			encodeAssignment(graph, solver, options.nbColors, options.clique);
+			return;
+		}
+
 		n_i.resize(nbNodes);
 
 		unsigned int index_of_variable = 0;
 
 		for(unsigned int i = 0; i < nbNodes; ++i) n_i[i] = index_of_variable++;
 
-		for(unsigned int i = 0; i < nbNodes; ++i) 
-		{	
-			s_ij.resize(nbNodes);
-			for(unsigned int j = i+1; j < nbNodes; ++j)
-			{
-				s_ij[i].resize(nbNodes);
-
-				s_ij[i][j] = ++index_of_variable;
-			} 
-		}
+		if(nbNodes > 1) index_of_variable = s_ij.initFull(nbNodes, index_of_variable+1);
 
 		while(solver->nVars() <= (int)index_of_variable) encoding.newSATVariable(solver);
 
 		/* To assure that two nodes connected are not in the same color. */
 		for(unsigned int i = 1; i <= nbNodes; ++i) 
 		{	
-			for(unsigned int j = i+1; j <= nbNodes; ++j)
+			for(unsigned int j : graph->neighbors(i))
 			{	
-				if(graph->are_nodes_connected(i,j))
+				if(j > i)
 				{	
-					if(verbose) cout << "c | ~s_"<<(i)<<"," << (j) << " (" << s_ij[i-1][j-1] << ")"  << endl;
+					if(verbose) cout << "c | ~s_"<<(i)<<"," << (j) << " (" << s_ij.find(i-1,j-1) << ")"  << endl;
 
 					/* if the nodes i and j are connected, they cannot be in the same color. */
-					encoding.addUnitClause(solver,Glucose::mkLit(s_ij[i-1][j-1],true));
+					encoding.addUnitClause(solver,Glucose::mkLit(s_ij.find(i-1,j-1),true));
 				}
 
 			}
 		}
 
-		if(graph->setOfTriplets.size() == 0)
+		if(native)
+		{
+			/* The solver propagates all the triples over the pairs. */
+			initTransitivity(solver);
+		}
+		else if(lazy && graph->setOfTriplets.size() == 0)
+		{
+			/* The transitivity clauses will come from the models which violate them. */
+		}
+		else if(graph->setOfTriplets.size() == 0)
 		{
 			/* To assure the transitivity and eucleanity of the colors. */
 			for(unsigned int i = 1; i <= nbNodes; ++i) 
@@ -73,31 +96,18 @@
 				{	
 					for(unsigned int k = j+1; k <= nbNodes; ++k)
 					{
-						if(verbose) cout << "c | s_"<<(i)<<"," << (j) << " (" << s_ij[i-1][j-1] << ")" << " & s_" << (j) << "," << (k) << " (" << s_ij[j-1][k-1] << ")" << " --> " << "s_" << (i) << "," << (k) << " (" << s_ij[i-1][k-1] << ")" << endl;
-						encoding.addTernaryClause(solver,Glucose::mkLit(s_ij[i-1][j-1],true),Glucose::mkLit(s_ij[j-1][k-1],true),Glucose::mkLit(s_ij[i-1][k-1],false));
+						if(verbose) cout << "c | s_"<<(i)<<"," << (j) << " (" << s_ij.find(i-1,j-1) << ")" << " & s_" << (j) << "," << (k) << " (" << s_ij.find(j-1,k-1) << ")" << " --> " << "s_" << (i) << "," << (k) << " (" << s_ij.find(i-1,k-1) << ")" << endl;
+						encoding.addTernaryClause(solver,Glucose::mkLit(s_ij.find(i-1,j-1),true),Glucose::mkLit(s_ij.find(j-1,k-1),true),Glucose::mkLit(s_ij.find(i-1,k-1),false));
 
-						if(verbose) cout << "c | s_"<<(i)<<"," << (j) << " (" << s_ij[i-1][j-1] << ")" << " & s_" << (i) << "," << (k) << " (" << s_ij[i-1][k-1] << ")" << " --> " << "s_" << (j) << "," << (k) << " (" << s_ij[j-1][k-1] << ")" << endl;
-						encoding.addTernaryClause(solver,Glucose::mkLit(s_ij[i-1][j-1],true),Glucose::mkLit(s_ij[i-1][k-1],true),Glucose::mkLit(s_ij[j-1][k-1],false));
+						if(verbose) cout << "c | s_"<<(i)<<"," << (j) << " (" << s_ij.find(i-1,j-1) << ")" << " & s_" << (i) << "," << (k) << " (" << s_ij.find(i-1,k-1) << ")" << " --> " << "s_" << (j) << "," << (k) << " (" << s_ij.find(j-1,k-1) << ")" << endl;
+						encoding.addTernaryClause(solver,Glucose::mkLit(s_ij.find(i-1,j-1),true),Glucose::mkLit(s_ij.find(i-1,k-1),true),Glucose::mkLit(s_ij.find(j-1,k-1),false));
 					}
 				}
 			}
 		} else {
-
-			for(auto triangle : graph->setOfTriplets)
-			{
-				unsigned int i = triangle[0]-1;
-				unsigned int j = triangle[1]-1;
-				unsigned int k = triangle[2]-1;
-
-				if(verbose) cout << "c | s_"<<(i+1)<<"," << (j+1) << " (" << s_ij[i][j] << ")" << " & s_" << (j+1) << "," << (k+1) << " (" << s_ij[j][k] << ")" << " --> " << "s_" << (i+1) << "," << (k+1) << " (" << s_ij[i][k] << ")" << endl;
-				encoding.addTernaryClause(solver,Glucose::mkLit(s_ij[i][j],true),Glucose::mkLit(s_ij[j][k],true),Glucose::mkLit(s_ij[i][k],false));
-
-				if(verbose) cout << "c | s_"<<(i+1)<<"," << (j+1) << " (" << s_ij[i][j] << ")" << " & s_" << (i+1) << "," << (k+1) << " (" << s_ij[i][k] << ")" << " --> " << "s_" << (j+1) << "," << (k+1) << " (" << s_ij[j][k] << ")" << endl;
-				encoding.addTernaryClause(solver,Glucose::mkLit(s_ij[i][j],true),Glucose::mkLit(s_ij[i][k],true),Glucose::mkLit(s_ij[j][k],false));
-			}
+			for(const msp::Triangle& triangle : graph->setOfTriplets) encodeTriangle(solver, triangle);
 		}
 
-
 		/* Now we need to count the number of colors needed */
 		for(unsigned int k = 2; k <= nbNodes; ++k)
 		{	
@@ -106,9 +116,9 @@
 			{	
 				if(i < k)
 				{
-					clause.push(Glucose::mkLit(s_ij[i-1][k-1],false));
-					if(verbose) cout << "c | ~n_" << (k) << " (" << n_i[k-1] << ")" << " v " << "~s_" << (i) << "," << (k) << " (" << s_ij[i-1][k-1] << ")" << endl;
-					encoding.addBinaryClause(solver,Glucose::mkLit(n_i[k-1],true),Glucose::mkLit(s_ij[i-1][k-1],true));
+					clause.push(Glucose::mkLit(s_ij.find(i-1,k-1),false));
+					if(verbose) cout << "c | ~n_" << (k) << " (" << n_i[k-1] << ")" << " v " << "~s_" << (i) << "," << (k) << " (" << s_ij.find(i-1,k-1) << ")" << endl;
+					encoding.addBinaryClause(solver,Glucose::mkLit(n_i[k-1],true),Glucose::mkLit(s_ij.find(i-1,k-1),true));
 				}
 			}
 
@@ -119,7 +129,7 @@
 				{
 					if(i < k) 
 					{
-						cout << "s_" << (i) << "," << (k) << " (" << s_ij[i-1][k-1] << ")";					
+						cout << "s_" << (i) << "," << (k) << " (" << s_ij.find(i-1,k-1) << ")";					
 						if(i+1 < nbNodes) cout << " v ";
 					}
 
@@ -131,4 +141,248 @@
 			clause.push(Glucose::mkLit(n_i[k-1],false));
 			solver->addClause(clause);
 		}		
+
+		freezePairs(solver);
+	}
+
+
+	void SAT_Encoding::encodeTriangle(Glucose::Solver* solver, const msp::Triangle& triangle)
+	{
+		openwbo::Totalizer encoding;
+
+		/* Each pair of the triangle follows from the two others. */
+		unsigned int v[3] = { triangle.i-1, triangle.j-1, triangle.k-1 };
+		int s[3] = { s_ij.find(v[1],v[2]), s_ij.find(v[0],v[2]), s_ij.find(v[0],v[1]) };
+
+		for(unsigned int c = 0; c < 3; ++c)
+		{
+			int a = s[(c+1) % 3], b = s[(c+2) % 3];
+
+			if(verbose) cout << "c | s (" << a << ") & s (" << b << ") --> s (" << s[c] << ")" << endl;
+			encoding.addTernaryClause(solver,Glucose::mkLit(a,true),Glucose::mkLit(b,true),Glucose::mkLit(s[c],false));
+		}
+	}
+
+	void SAT_Encoding::initTransitivity(Glucose::Solver* solver)
+	{
+		solver->initTransitivity(s_ij);
+	}
+
+
+	void SAT_Encoding::freezePairs(Glucose::Solver* solver)
+	{
+		/* The lemmas may mention any pair, so the preprocessing must not eliminate them. */
+		Glucose::SimpSolver* simp = dynamic_cast<Glucose::SimpSolver*>(solver);
+		if(!(lazy || native) || !simp) return;
+
+		for(unsigned int j = 0; j < nbNodes; ++j)
+			for(uint64_t t = 0; t < s_ij.nbLower(j); ++t) simp->setFrozen(s_ij.variable(j,t), true);
+	}
+
+
+	void SAT_Encoding::encodeAssignment(Graph* graph, Glucose::Solver* solver, unsigned int maxColors, const vector<unsigned int>& clique)
+	{
+		openwbo::Totalizer encoding;
+
+		/* A greedy coloring never needs more than max degree + 1 colors. */
+		if(maxColors == 0)
+		{
+			for(unsigned int v = 1; v <= nbNodes; ++v) maxColors = std::max(maxColors, graph->degree(v) + 1);
+		}
+
+		nbColors = std::min(maxColors, nbNodes);
+
+		/* The colors are numbered by their first vertex in colorOrder: the clique, then the other vertices by id. */
+		vector<unsigned int> position(nbNodes, nbNodes);
+
+		for(unsigned int v : clique) { position[v-1] = colorOrder.size(); colorOrder.push_back(v-1); }
+		for(unsigned int v = 0; v < nbNodes; ++v) if(position[v] == nbNodes) { position[v] = colorOrder.size(); colorOrder.push_back(v); }
+
+		/* The variable 0 is left unused, as in the pairwise encoding. */
+		unsigned int index_of_variable = 0;
+
+		y_c.resize(nbColors);
+		for(unsigned int c = 0; c < nbColors; ++c) y_c[c] = ++index_of_variable;
+
+		x_vc.resize((uint64_t)nbNodes * nbColors);
+		for(uint64_t p = 0; p < x_vc.size(); ++p) x_vc[p] = ++index_of_variable;
+
+		while(solver->nVars() <= (int)index_of_variable) encoding.newSATVariable(solver);
+
+		for(unsigned int v = 0; v < nbNodes; ++v)
+		{
+			const unsigned int* x_v = &x_vc[(uint64_t)v * nbColors];
+
+			/* Every vertex has a color, and the vertex at position p can only take one of the colors 0..p. */
+			Glucose::vec<Glucose::Lit> clause;
+			for(unsigned int c = 0; c < nbColors; ++c)
+			{
+				if(c <= position[v])
+				{
+					clause.push(Glucose::mkLit(x_v[c],false));
+					encoding.addBinaryClause(solver,Glucose::mkLit(x_v[c],true),Glucose::mkLit(y_c[c],false));
+				}
+				else encoding.addUnitClause(solver,Glucose::mkLit(x_v[c],true));
+			}
+			solver->addClause(clause);
+
+			/* The clique vertices are pairwise connected: they open the first colors, one each. */
+			if(position[v] < clique.size() && position[v] < nbColors) encoding.addUnitClause(solver,Glucose::mkLit(x_v[position[v]],false));
+
+			/* Two vertices connected cannot have the same color. */
+			for(unsigned int w : graph->neighbors(v+1))
+			{
+				if(w-1 <= v) continue;
+
+				const unsigned int* x_w = &x_vc[(uint64_t)(w-1) * nbColors];
+				for(unsigned int c = 0; c <= std::min(position[v], position[w-1]) && c < nbColors; ++c)
+					encoding.addBinaryClause(solver,Glucose::mkLit(x_v[c],true),Glucose::mkLit(x_w[c],true));
+			}
+		}
+
+		/* The colors are used in order, so that removing the color k removes all the ones above it. */
+		for(unsigned int c = 1; c < nbColors; ++c)
+			encoding.addBinaryClause(solver,Glucose::mkLit(y_c[c],true),Glucose::mkLit(y_c[c-1],false));
+	}
+
+
+	void SAT_Encoding::colorLiterals(Glucose::vec<Glucose::Lit>& lits) const
+	{
+		lits.clear();
+
+		if(kind == ENCODING_ASSIGNMENT)
+		{
+			for(unsigned int c = 1; c < nbColors; ++c) lits.push(Glucose::mkLit(y_c[c],false));
+		}
+		else
+		{
+			/* n_k is true when the vertex k is not the same as any earlier one, i.e. opens a new color. */
+			for(unsigned int i = 1; i < nbNodes; ++i) lits.push(Glucose::mkLit(n_i[i],false));
+		}
+	}
+
+
+	void SAT_Encoding::boundColors(Glucose::Solver* solver, unsigned int k, Glucose::vec<Glucose::Lit>& assumptions)
+	{
+		assumptions.clear();
+
+		Glucose::vec<Glucose::Lit> lits;
+		colorLiterals(lits);
+
+		/* Built on the first call, before any solve: the adder of the pairwise encoding covers all the literals,
+		   each bound then only adds its own activation literal. Everything a later bound refers to is frozen
+		   so that the preprocessing of the first solve does not eliminate it. */
+		if(!adderBuilt)
+		{
+			int firstVar = solver->nVars();
+
+			if(kind == ENCODING_PAIRWISE && lits.size() > 1)
+			{
+				Glucose::vec<uint64_t> coeffs;
+				Glucose::vec<Glucose::Lit> unused;
+				for(int i = 0; i < lits.size(); ++i) coeffs.push(1);
+
+				adder.encodeInc(solver, lits, coeffs, lits.size(), unused);
+			}
+			adderBuilt = true;
+
+			Glucose::SimpSolver* simp = dynamic_cast<Glucose::SimpSolver*>(solver);
+			if(simp)
+			{
+				for(int i = 0; i < lits.size(); ++i) simp->setFrozen(var(lits[i]), true);
+				for(int v = firstVar; v < solver->nVars(); ++v) simp->setFrozen(v, true);
+			}
+		}
+
+		if(k > (unsigned int)lits.size()) return;
+
+		if(kind == ENCODING_ASSIGNMENT)
+		{
+			assumptions.push(~lits[k-1]);
+			return;
+		}
+
+		if(k == 1)
+		{
+			for(int i = 0; i < lits.size(); ++i) assumptions.push(~lits[i]);
+			return;
+		}
+
+		adder.updateInc(solver, k-1, assumptions);
+	}
+
+
+	bool SAT_Encoding::setPhases(Glucose::Solver* solver, const vector<unsigned int>& color) const
+	{
+		/* In Glucose, the polarity true makes the variable false first. */
+		if(kind == ENCODING_ASSIGNMENT)
+		{
+			/* The same coloring, with the colors numbered as the encoding does (see colorOrder). */
+			vector<unsigned int> renamed(nbNodes, nbNodes);
+			unsigned int used = 0;
+
+			for(unsigned int v : colorOrder) if(renamed[color[v+1]] == nbNodes) renamed[color[v+1]] = used++;
+
+			if(used > nbColors) return false;
+
+			for(unsigned int v = 0; v < nbNodes; ++v)
+				for(unsigned int c = 0; c < nbColors; ++c) solver->setPolarity(x_vc[(uint64_t)v * nbColors + c], renamed[color[v+1]] != c);
+
+			for(unsigned int c = 0; c < nbColors; ++c) solver->setPolarity(y_c[c], c >= used);
+
+			return true;
+		}
+
+		vector<bool> opened(nbNodes, false);
+
+		for(unsigned int j = 0; j < nbNodes; ++j)
+		{
+			for(uint64_t t = 0; t < s_ij.nbLower(j); ++t)
+				solver->setPolarity(s_ij.variable(j,t), color[s_ij.lower(j,t)+1] != color[j+1]);
+
+			solver->setPolarity(n_i[j], opened[color[j+1]]);
+			opened[color[j+1]] = true;
+		}
+
+		return true;
+	}
+
+
+	unsigned int SAT_Encoding::decode(const vector<bool>& model, vector<unsigned int>& color) const
+	{
+		color.assign(nbNodes, 0);
+
+		if(kind == ENCODING_ASSIGNMENT)
+		{
+			vector<bool> used(nbColors, false);
+			unsigned int nbUsed = 0;
+
+			for(unsigned int v = 0; v < nbNodes; ++v)
+			{
+				const unsigned int* x_v = &x_vc[(uint64_t)v * nbColors];
+
+				unsigned int c = 0;
+				while(c + 1 < nbColors && !model[x_v[c]]) c++;
+
+				color[v] = c;
+				if(!used[c]) { used[c] = true; nbUsed++; }
+			}
+
+			return nbUsed;
+		}
+
+		/* A vertex takes the color of its first earlier vertex marked as the same, a new one otherwise. */
+		unsigned int nbUsed = 0;
+
+		for(unsigned int j = 0; j < nbNodes; ++j)
+		{
+			color[j] = nbUsed;
+			for(uint64_t t = 0; t < s_ij.nbLower(j); ++t)
+			{
+				if(model[s_ij.variable(j,t)]) { color[j] = color[s_ij.lower(j,t)]; break; }
+			}
+			if(color[j] == nbUsed) nbUsed++;
+		}
+
+		return nbUsed;
 	}
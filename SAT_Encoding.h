@@ -21,13 +21,38 @@
 #define SAT_ENCODING_H
 
 #include "Graph.h"
+#include "PairIndex.h"
 #include "SimpSolver.h"
 #include "Encoder.h"
 #include "Enc_Totalizer.h"
+#include "Enc_Adder.h"
 
 using namespace std;
 using namespace msp;
 
+/* The pairwise encoding says which vertices share a color (s_ij), the assignment one gives each vertex its color (x_vc). */
+enum EncodingKind { ENCODING_PAIRWISE, ENCODING_ASSIGNMENT };
+
+/* Returns the encoding called name ("pairwise" or "assignment"), exits on an unknown name. */
+EncodingKind encoding_from_name(const char* name);
+
+struct EncodingOptions {
+
+	EncodingKind kind = ENCODING_PAIRWISE;
+
+	/* Pairwise: no transitivity clause up front, ModelChecker adds the violated ones as lemmas (see addTransitivityLemmas). */
+	bool lazy = false;
+
+	/* Pairwise: no transitivity clause at all, the solver propagates the triples itself (Solver::initTransitivity). */
+	bool native = false;
+
+	/* Assignment: number of colors encoded, 0 for the greedy bound (max degree + 1). */
+	unsigned int nbColors = 0;
+
+	/* Assignment: vertices (from 1) of a clique, which take the colors 0, 1, ... (see max_clique). */
+	vector<unsigned int> clique;
+};
+
 class SAT_Encoding {
 
 private:
@@ -36,15 +61,64 @@ private:
 
 	unsigned int nbNodes;
 
+	EncodingKind kind;
+
+	bool lazy;
+
+	bool native;
+
+	/* Bounds the number of true color literals of the pairwise encoding, built by the first boundColors. */
+	openwbo::Adder adder;
+	bool adderBuilt = false;
+
+	/* Adds the three transitivity clauses of a triangle of the chordal completion. */
+	void encodeTriangle(Glucose::Solver* solver, const msp::Triangle& triangle);
+
+	void freezePairs(Glucose::Solver* solver);
+
+	void initTransitivity(Glucose::Solver* solver);
+
+	void encodeAssignment(Graph* graph, Glucose::Solver* solver, unsigned int nbColors, const vector<unsigned int>& clique);
+
+	/* Assignment encoding: the vertices (0-based) in the order their colors are numbered, the clique first. */
+	vector<unsigned int> colorOrder;
+
 public:
 
-	vector< vector<unsigned int> > s_ij;
+	/* The variable of each pair of vertices (0-based), see PairIndex. */
+	PairIndex s_ij;
 
 	vector<unsigned int> n_i;
 
+	/* Assignment encoding: x_vc[v * nbColors + c] is true if the vertex v (0-based) has the color c, y_c[c] if c is used. */
+	vector<unsigned int> x_vc;
+	vector<unsigned int> y_c;
+
+	unsigned int nbColors;
+
 	inline unsigned int getNbNodes() { return nbNodes; }
 
-	SAT_Encoding(Graph* g, Glucose::Solver* solver);
+	inline EncodingKind getKind() const { return kind; }
+
+	inline bool isLazy() const { return lazy; }
+
+	/* Returns the largest number of colors the formula can express. */
+	inline unsigned int getMaxColors() const { return nbColors; }
+
+	/* The literals counting the colors beyond the first one: n_i (i > 0) or y_c (c > 0). */
+	void colorLiterals(Glucose::vec<Glucose::Lit>& lits) const;
+
+	/* Replaces the assumptions by ones allowing at most k colors (k >= 1). */
+	void boundColors(Glucose::Solver* solver, unsigned int k, Glucose::vec<Glucose::Lit>& assumptions);
+
+	/* Makes the solver try the coloring first (color[v] for the vertices 1..n, e.g. from heuristic_coloring).
+	   Returns false, without touching the solver, if the formula cannot express this coloring. */
+	bool setPhases(Glucose::Solver* solver, const vector<unsigned int>& color) const;
+
+	/* Gives a color to each vertex (0-based) from the model, returns the number of colors. */
+	unsigned int decode(const vector<bool>& model, vector<unsigned int>& color) const;
+
+	SAT_Encoding(Graph* g, Glucose::Solver* solver, const EncodingOptions& options = EncodingOptions());
 
 	~SAT_Encoding() { }
 
@@ -648,6 +648,8 @@ bool SimpSolver::eliminateVar(Var v)
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watchesTer[ mkLit(v)].size() == 0) watchesTer[ mkLit(v)].clear(true);
+    if (watchesTer[~mkLit(v)].size() == 0) watchesTer[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
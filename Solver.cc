@@ -155,6 +155,7 @@ Solver::Solver() :
 , vbyte(false)
 , panicModeLastRemoved(0), panicModeLastRemovedShared(0)
 , useUnaryWatched(false)
+, useTernaryWatches(false)
 , promoteOneWatchedClause(true)
 ,solves(0),starts(0),decisions(0),propagations(0),conflicts(0),conflictsRestarts(0)
 , curRestart(1)
@@ -175,6 +176,7 @@ Solver::Solver() :
 , watches(WatcherDeleted(ca))
 , watchesBin(WatcherDeleted(ca))
 , unaryWatches(WatcherDeleted(ca))
+, watchesTer(TernaryWatcherDeleted(ca))
 , qhead(0)
 , simpDB_assigns(-1)
 , simpDB_props(0)
@@ -189,6 +191,9 @@ Solver::Solver() :
 , asynch_interrupt(false)
 , incremental(false)
 , nbVarsInitialFormula(INT32_MAX)
+, transitivityVertices(0)
+, transitivityIndex(NULL)
+, theoryConflict(CRef_Undef)
 , totalTime4Sat(0.)
 , totalTime4Unsat(0.)
 , nbSatCalls(0)
@@ -238,6 +243,7 @@ Solver::Solver(const Solver &s) :
 , certifiedUNSAT(false) // Not in the first parallel version
 , panicModeLastRemoved(s.panicModeLastRemoved), panicModeLastRemovedShared(s.panicModeLastRemovedShared)
 , useUnaryWatched(s.useUnaryWatched)
+, useTernaryWatches(s.useTernaryWatches)
 , promoteOneWatchedClause(s.promoteOneWatchedClause)
 // Statistics: (formerly in 'SolverStats')
 //
@@ -260,6 +266,7 @@ Solver::Solver(const Solver &s) :
 , watches(WatcherDeleted(ca))
 , watchesBin(WatcherDeleted(ca))
 , unaryWatches(WatcherDeleted(ca))
+, watchesTer(TernaryWatcherDeleted(ca))
 , qhead(s.qhead)
 , simpDB_assigns(s.simpDB_assigns)
 , simpDB_props(s.simpDB_props)
@@ -274,6 +281,9 @@ Solver::Solver(const Solver &s) :
 , asynch_interrupt(s.asynch_interrupt)
 , incremental(s.incremental)
 , nbVarsInitialFormula(s.nbVarsInitialFormula)
+, transitivityVertices(s.transitivityVertices)
+, transitivityIndex(s.transitivityIndex)
+, theoryConflict(CRef_Undef)
 , totalTime4Sat(s.totalTime4Sat)
 , totalTime4Unsat(s.totalTime4Unsat)
 , nbSatCalls(s.nbSatCalls)
@@ -293,6 +303,7 @@ Solver::Solver(const Solver &s) :
     // Copy all search vectors
     s.watches.copyTo(watches);
     s.watchesBin.copyTo(watchesBin);
+    s.watchesTer.copyTo(watchesTer);
     s.unaryWatches.copyTo(unaryWatches);
     s.assigns.memCopyTo(assigns);
     s.vardata.memCopyTo(vardata);
@@ -311,6 +322,8 @@ Solver::Solver(const Solver &s) :
     s.trailQueue.copyTo(trailQueue);
     s.forceUNSAT.copyTo(forceUNSAT);
     s.stats.copyTo(stats);
+    s.transitivityEnds.memCopyTo(transitivityEnds);
+    s.theoryReasons.memCopyTo(theoryReasons);
 }
 
 
@@ -372,6 +385,8 @@ Var Solver::newVar(bool sign, bool dvar) {
     watches.init(mkLit(v, true));
     watchesBin.init(mkLit(v, false));
     watchesBin.init(mkLit(v, true));
+    watchesTer.init(mkLit(v, false));
+    watchesTer.init(mkLit(v, true));
     unaryWatches.init(mkLit(v, false));
     unaryWatches.init(mkLit(v, true));
     assigns.push(l_Undef);
@@ -463,6 +478,10 @@ void Solver::attachClause(CRef cr) {
     if(c.size() == 2) {
         watchesBin[~c[0]].push(Watcher(cr, c[1]));
         watchesBin[~c[1]].push(Watcher(cr, c[0]));
+    } else if(c.size() == 3 && useTernaryWatches) {
+        watchesTer[~c[0]].push(TernaryWatcher(cr, c[1], c[2]));
+        watchesTer[~c[1]].push(TernaryWatcher(cr, c[0], c[2]));
+        watchesTer[~c[2]].push(TernaryWatcher(cr, c[0], c[1]));
     } else {
         watches[~c[0]].push(Watcher(cr, c[1]));
         watches[~c[1]].push(Watcher(cr, c[0]));
@@ -494,6 +513,14 @@ void Solver::detachClause(CRef cr, bool strict) {
             watchesBin.smudge(~c[0]);
             watchesBin.smudge(~c[1]);
         }
+    } else if(c.size() == 3 && useTernaryWatches) {
+        if(strict) {
+            for(int i = 0; i < 3; i++)
+                remove(watchesTer[~c[i]], TernaryWatcher(cr, lit_Undef, lit_Undef));
+        } else {
+            for(int i = 0; i < 3; i++)
+                watchesTer.smudge(~c[i]);
+        }
     } else {
         if(strict) {
             remove(watches[~c[0]], Watcher(cr, c[1]));
@@ -546,7 +573,8 @@ void Solver::removeClause(CRef cr, bool inPurgatory) {
     else
         detachClause(cr);
     // Don't leave pointers to free'd memory!
-    if(locked(c)) vardata[var(c[0])].reason = CRef_Undef;
+    Lit implied = lockedLit(c);
+    if(implied != lit_Undef) vardata[var(implied)].reason = CRef_Undef;
     c.mark(1);
     ca.free(cr);
 }
@@ -603,6 +631,31 @@ template <typename T>inline unsigned int Solver::computeLBD(const T &lits, int e
 }
 
 
+// Every learnt clause met by analyze() comes here, whichever list propagated it:
+// the clauses of size 3 of watchesTer reach it as conflicts or through reasonClause().
+void Solver::updateLBD(CRef cr) {
+    Clause &c = ca[cr];
+    if(c.lbd() <= 2) return;
+
+    unsigned int nblevels = computeLBD(c);
+    if(nblevels + 1 < c.lbd()) { // improve the LBD
+        if(c.lbd() <= lbLBDFrozenClause) {
+            // seems to be interesting : keep it for the next round
+            c.setCanBeDel(false);
+        }
+        if(chanseokStrategy && nblevels <= coLBDBound) {
+            c.nolearnt();
+            learnts.remove(cr);
+            permanentLearnts.push(cr);
+            stats[nbPermanentLearnts]++;
+
+        } else {
+            c.setLBD(nblevels); // Update it
+        }
+    }
+}
+
+
 
 /******************************************************************
  * Minimisation with binary reolution
@@ -656,6 +709,11 @@ void Solver::cancelUntil(int level) {
         for(int c = trail.size() - 1; c >= trail_lim[level]; c--) {
             Var x = var(trail[c]);
             assigns[x] = l_Undef;
+            // the clause of a theory implication lives as long as the implication
+            if(x < theoryReasons.size() / 2 && theoryReasons[2 * x] != lit_Undef) {
+                if(vardata[x].reason != CRef_Lazy) ca.free(vardata[x].reason);
+                theoryReasons[2 * x] = lit_Undef;
+            }
             if(phase_saving > 1 || ((phase_saving == 1) && c > trail_lim.last())) {
                 polarity[x] = sign(trail[c]);
             }
@@ -760,24 +818,7 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
         }
 
         // DYNAMIC NBLEVEL trick (see competition'09 companion paper)
-        if(c.learnt() && c.lbd() > 2) {
-            unsigned int nblevels = computeLBD(c);
-            if(nblevels + 1 < c.lbd()) { // improve the LBD
-                if(c.lbd() <= lbLBDFrozenClause) {
-                    // seems to be interesting : keep it for the next round
-                    c.setCanBeDel(false);
-                }
-                if(chanseokStrategy && nblevels <= coLBDBound) {
-                    c.nolearnt();
-                    learnts.remove(confl);
-                    permanentLearnts.push(confl);
-                    stats[nbPermanentLearnts]++;
-
-                } else {
-                    c.setLBD(nblevels); // Update it
-                }
-            }
-        }
+        if(c.learnt()) updateLBD(confl);
 
 
         for(int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++) {
@@ -797,7 +838,7 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
                     if(level(var(q)) >= decisionLevel()) {
                         pathC++;
                         // UPDATEVARACTIVITY trick (see competition'09 companion paper)
-                        if(!isSelector(var(q)) && (reason(var(q)) != CRef_Undef) && ca[reason(var(q))].learnt())
+                        if(!isSelector(var(q)) && (reason(var(q)) < CRef_Lazy) && ca[reason(var(q))].learnt())
                             lastDecisionLevel.push(q);
                     } else {
                         if(isSelector(var(q))) {
@@ -814,7 +855,7 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
         while (!seen[var(trail[index--])]);
         p = trail[index + 1];
         //stats[sumRes]++;
-        confl = reason(var(p));
+        confl = reasonClause(var(p));
         seen[var(p)] = 0;
         pathC--;
 
@@ -845,7 +886,7 @@ void Solver::analyze(CRef confl, vec <Lit> &out_learnt, vec <Lit> &selectors, in
             if(reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else {
-                Clause &c = ca[reason(var(out_learnt[i]))];
+                Clause &c = ca[reasonClause(var(out_learnt[i]))];
                 // Thanks to Siert Wieringa for this bug fix!
                 for(int k = ((c.size() == 2) ? 0 : 1); k < c.size(); k++)
                     if(!seen[var(c[k])] && level(var(c[k])) > 0) {
@@ -925,7 +966,7 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels) {
     int top = analyze_toclear.size();
     while(analyze_stack.size() > 0) {
         assert(reason(var(analyze_stack.last())) != CRef_Undef);
-        Clause &c = ca[reason(var(analyze_stack.last()))];
+        Clause &c = ca[reasonClause(var(analyze_stack.last()))];
         analyze_stack.pop(); //
         if(c.size() == 2 && value(c[0]) == l_False) {
             assert(value(c[1]) == l_True);
@@ -981,7 +1022,7 @@ void Solver::analyzeFinal(Lit p, vec <Lit> &out_conflict) {
                 assert(level(x) > 0);
                 out_conflict.push(~trail[i]);
             } else {
-                Clause &c = ca[reason(x)];
+                Clause &c = ca[reasonClause(x)];
                 //                for (int j = 1; j < c.size(); j++) Minisat (glucose 2.0) loop
                 // Bug in case of assumptions due to special data structures for Binary.
                 // Many thanks to Sam Bayless (sbayless@cs.ubc.ca) for discover this bug.
@@ -1026,8 +1067,10 @@ void Solver::bumpForceUNSAT(Lit q) {
 CRef Solver::propagate() {
     CRef confl = CRef_Undef;
     int num_props = 0;
+    uint64_t ternary_props = 0; // added to stats once per call, not on each propagation
     watches.cleanAll();
     watchesBin.cleanAll();
+    watchesTer.cleanAll();
     unaryWatches.cleanAll();
     while(qhead < trail.size()) {
         Lit p = trail[qhead++]; // 'p' is enqueued fact to propagate.
@@ -1043,6 +1086,7 @@ CRef Solver::propagate() {
             Lit imp = wbin[k].blocker;
 
             if(value(imp) == l_False) {
+                if(ternary_props > 0) stats[nbTernaryPropagations] += ternary_props;
                 return wbin[k].cref;
             }
 
@@ -1051,6 +1095,29 @@ CRef Solver::propagate() {
             }
         }
 
+        // Then clauses of size 3, without reading them
+        vec <TernaryWatcher> &wter = watchesTer[p];
+        for(int k = 0; k < wter.size(); k++) {
+            lbool v1 = value(wter[k].other1);
+            if(v1 == l_True) continue;
+            lbool v2 = value(wter[k].other2);
+            if(v2 == l_True) continue;
+
+            if(v1 == l_False && v2 == l_False) {
+                stats[nbTernaryConflicts]++;
+                stats[nbTernaryPropagations] += ternary_props;
+                return wter[k].cref;
+            }
+
+            if(v1 == l_False && v2 == l_Undef) {
+                ternary_props++;
+                uncheckedEnqueue(wter[k].other2, wter[k].cref);
+            } else if(v2 == l_False && v1 == l_Undef) {
+                ternary_props++;
+                uncheckedEnqueue(wter[k].other1, wter[k].cref);
+            }
+        }
+
         // Now propagate other 2-watched clauses
         for(i = j = (Watcher *) ws, end = i + ws.size(); i != end;) {
             // Try to avoid inspecting the clause:
@@ -1138,11 +1205,18 @@ CRef Solver::propagate() {
 
         }
 
+        // Transitivity theory
+        if(transitivityVertices > 0 && confl == CRef_Undef) {
+            confl = propagateTransitivity(p);
+            if(confl != CRef_Undef) qhead = trail.size();
+        }
+
     }
 
 
     propagations += num_props;
     simpDB_props -= num_props;
+    stats[nbTernaryPropagations] += ternary_props;
 
     return confl;
 }
@@ -1233,6 +1307,118 @@ CRef Solver::propagateUnaryWatches(Lit p) {
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  propagateTransitivity : [Lit]  ->  [Clause*]
+|
+|  Description:
+|    Propagates the triples (i,j,k) of the pair variable s_ij of p: s_ij & s_ik -> s_jk,
+|    s_ij & s_jk -> s_ik and s_ik & s_jk -> s_ij.
+|    The implied literals get the reason CRef_Lazy, their clause is only built if the
+|    conflict analysis needs it, and freed when they are unassigned: the theory never
+|    adds clauses to the formula. Returns the violated triple, otherwise CRef_Undef.
+|________________________________________________________________________________________________@*/
+CRef Solver::propagateTransitivity(Lit p) {
+    Var v = var(p);
+    if(2 * v >= transitivityEnds.size() || transitivityEnds[2 * v] < 0) return CRef_Undef;
+
+    int n = transitivityVertices;
+    int i = transitivityEnds[2 * v], j = transitivityEnds[2 * v + 1];
+    Lit ij = mkLit(v);
+    vec <Lit> lits;
+
+    for(int k = 0; k < n; k++) {
+        if(k == i || k == j) continue;
+        Lit ik = mkLit(transitivityIndex->find(i, k));
+        Lit jk = mkLit(transitivityIndex->find(j, k));
+        lbool a = value(ik);
+        lbool b = value(jk);
+
+        lits.clear();
+        if(!sign(p)) { // s_ij
+            if(a == l_True) {
+                if(b == l_Undef) { theoryEnqueue(jk, ~ij, ~ik); continue; }
+                if(b == l_False) { lits.push(~ij); lits.push(~ik); lits.push(jk); }
+            } else if(b == l_True) {
+                if(a == l_Undef) { theoryEnqueue(ik, ~ij, ~jk); continue; }
+                lits.push(~ij); lits.push(~jk); lits.push(ik);
+            } else if(a == l_False && b == l_Undef) {
+                theoryEnqueue(~jk, ~ij, ik);
+            } else if(b == l_False && a == l_Undef) {
+                theoryEnqueue(~ik, ~ij, jk);
+            }
+        } else { // ~s_ij
+            if(a == l_True && b == l_Undef) theoryEnqueue(~jk, ~ik, ij);
+            else if(b == l_True && a == l_Undef) theoryEnqueue(~ik, ~jk, ij);
+            else if(a == l_True && b == l_True) { lits.push(~ik); lits.push(~jk); lits.push(ij); }
+        }
+
+        if(lits.size() > 0) {
+            // not attached nor kept: the clause only serves the analysis of this conflict
+            stats[nbTheoryConflicts]++;
+            theoryConflict = ca.alloc(lits, false);
+            return theoryConflict;
+        }
+    }
+
+    return CRef_Undef;
+}
+
+
+void Solver::theoryEnqueue(Lit p, Lit a, Lit b) {
+    if(theoryReasons.size() < 2 * nVars()) theoryReasons.growTo(2 * nVars(), lit_Undef);
+    theoryReasons[2 * var(p)] = a;
+    theoryReasons[2 * var(p) + 1] = b;
+    stats[nbTheoryPropagations]++;
+    uncheckedEnqueue(p, CRef_Lazy);
+}
+
+
+CRef Solver::reasonClause(Var x) {
+    if(vardata[x].reason != CRef_Lazy) {
+        // watchesTer does not move the implied literal of a clause of size 3 in front: analysis expects it there
+        CRef cr = vardata[x].reason;
+        if(cr != CRef_Undef && useTernaryWatches) {
+            Clause &c = ca[cr];
+            if(c.size() == 3 && var(c[0]) != x) {
+                int i = var(c[1]) == x ? 1 : 2;
+                Lit tmp = c[0];
+                c[0] = c[i];
+                c[i] = tmp;
+            }
+        }
+        return cr;
+    }
+
+    vec <Lit> lits;
+    lits.push(mkLit(x, value(x) == l_False));
+    lits.push(theoryReasons[2 * x]);
+    lits.push(theoryReasons[2 * x + 1]);
+
+    // the implied literal comes first, as in the reasons of the clauses; the clause is neither attached nor kept
+    stats[nbTheoryReasons]++;
+    vardata[x].reason = ca.alloc(lits, false);
+    return vardata[x].reason;
+}
+
+
+void Solver::initTransitivity(const msp::PairIndex& pairs) {
+    transitivityVertices = pairs.getNbVertices();
+    transitivityIndex = &pairs;
+    transitivityEnds.clear();
+
+    for(unsigned int j = 0; j < pairs.getNbVertices(); j++)
+        for(uint64_t t = 0; t < pairs.nbLower(j); t++) {
+            Var v = pairs.variable(j, t);
+            if(transitivityEnds.size() < 2 * (v + 1)) transitivityEnds.growTo(2 * (v + 1), -1);
+            transitivityEnds[2 * v] = pairs.lower(j, t);
+            transitivityEnds[2 * v + 1] = j;
+        }
+
+    qhead = 0; // the facts already on the trail go through the theory as well
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  reduceDB : ()  ->  [void]
@@ -1525,6 +1711,11 @@ lbool Solver::search(int nof_conflicts) {
 
             analyze(confl, learnt_clause, selectors, backtrack_level, nblevels, szWithoutSelectors);
 
+            if(confl == theoryConflict) {
+                ca.free(theoryConflict);
+                theoryConflict = CRef_Undef;
+            }
+
             lbdQueue.push(nblevels);
             sumLBD += nblevels;
 
@@ -1688,6 +1879,25 @@ void Solver::printIncrementalStats() {
     printf("c | nb learnts size 1     : %"
     PRIu64
     "\n", stats[nbUn]);
+    if(transitivityVertices > 0) {
+        printf("c | Theory propagations   : %"
+        PRIu64
+        "\n", stats[nbTheoryPropagations]);
+        printf("c | Theory conflicts      : %"
+        PRIu64
+        "\n", stats[nbTheoryConflicts]);
+        printf("c | Theory reasons built  : %"
+        PRIu64
+        "\n", stats[nbTheoryReasons]);
+    }
+    if(useTernaryWatches) {
+        printf("c | Ternary propagations  : %"
+        PRIu64
+        "\n", stats[nbTernaryPropagations]);
+        printf("c | Ternary conflicts     : %"
+        PRIu64
+        "\n", stats[nbTernaryConflicts]);
+    }
 
     printf("c | Conflicts             : %"
     PRIu64
@@ -1914,6 +2124,7 @@ void Solver::relocAll(ClauseAllocator &to) {
     // for (int i = 0; i < watches.size(); i++)
     watches.cleanAll();
     watchesBin.cleanAll();
+    watchesTer.cleanAll();
     unaryWatches.cleanAll();
     for(int v = 0; v < nVars(); v++)
         for(int s = 0; s < 2; s++) {
@@ -1928,6 +2139,9 @@ void Solver::relocAll(ClauseAllocator &to) {
             vec <Watcher> &ws3 = unaryWatches[p];
             for(int j = 0; j < ws3.size(); j++)
                 ca.reloc(ws3[j].cref, to);
+            vec <TernaryWatcher> &ws4 = watchesTer[p];
+            for(int j = 0; j < ws4.size(); j++)
+                ca.reloc(ws4[j].cref, to);
         }
 
     // All reasons:
@@ -1935,10 +2149,14 @@ void Solver::relocAll(ClauseAllocator &to) {
     for(int i = 0; i < trail.size(); i++) {
         Var v = var(trail[i]);
 
-        if(reason(v) != CRef_Undef && (ca[reason(v)].reloced() || locked(ca[reason(v)])))
+        if(reason(v) < CRef_Lazy && (ca[reason(v)].reloced() || locked(ca[reason(v)])))
             ca.reloc(vardata[v].reason, to);
     }
 
+    // A theory conflict is not kept past its analysis:
+    //
+    theoryConflict = CRef_Undef;
+
     // All learnt:
     //
     for(int i = 0; i < learnts.size(); i++)
@@ -58,6 +58,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "SolverStats.h"
 #include "SolverTypes.h"
 #include "Options.h"
+#include "PairIndex.h"
 
 
 namespace Glucose {
@@ -87,10 +88,15 @@ enum CoreStats {
   learnts_literals,
   max_literals,
   tot_literals,
-  noDecisionConflict
+  noDecisionConflict,
+  nbTheoryPropagations,
+  nbTheoryConflicts,
+  nbTheoryReasons,
+  nbTernaryPropagations,
+  nbTernaryConflicts
 } ;
 
-#define coreStatsSize 24
+#define coreStatsSize 29
 //=================================================================================================
 // Solver -- the main class:
 
@@ -175,6 +181,10 @@ public:
     void initNbInitialVars(int nb);
     void printIncrementalStats();
     bool isIncremental();
+
+    // Transitivity theory over the pair variables of the index, which must outlive the solving.
+    void initTransitivity(const msp::PairIndex& pairs);
+
     // Resource contraints:
     //
     void    setConfBudget(int64_t x);
@@ -252,6 +262,7 @@ protected:
     uint32_t panicModeLastRemoved, panicModeLastRemovedShared;
     
     bool useUnaryWatched;            // Enable unary watched literals
+    bool useTernaryWatches;          // Clauses of size 3 go to watchesTer (set before adding any clause)
     bool promoteOneWatchedClause;    // One watched clauses are promotted to two watched clauses if found empty
     
     // Functions useful for multithread solving
@@ -318,6 +329,23 @@ protected:
         bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
     };
 
+    // A clause of size 3 is watched on its three literals, with the two others inline:
+    // propagating it never reads the clause itself.
+    struct TernaryWatcher {
+        CRef cref;
+        Lit  other1, other2;
+        TernaryWatcher(CRef cr, Lit p, Lit q) : cref(cr), other1(p), other2(q) {}
+        bool operator==(const TernaryWatcher& w) const { return cref == w.cref; }
+        bool operator!=(const TernaryWatcher& w) const { return cref != w.cref; }
+    };
+
+    struct TernaryWatcherDeleted
+    {
+        const ClauseAllocator& ca;
+        TernaryWatcherDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
+        bool operator()(const TernaryWatcher& w) const { return ca[w.cref].mark() == 1; }
+    };
+
     struct VarOrderLt {
         const vec<double>&  activity;
         bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
@@ -338,6 +366,8 @@ protected:
                         watchesBin;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
     OccLists<Lit, vec<Watcher>, WatcherDeleted>
                         unaryWatches;       //  Unary watch scheme (clauses are seen when they become empty
+    OccLists<Lit, vec<TernaryWatcher>, TernaryWatcherDeleted>
+                        watchesTer;       // 'watchesTer[lit]' lists the clauses of size 3 containing ~lit, see TernaryWatcher.
     vec<CRef>           clauses;          // List of problem clauses.
     vec<CRef>           learnts;          // List of learnt clauses.
     vec<CRef>           permanentLearnts; // The list of learnts clauses kept permanently
@@ -406,6 +436,15 @@ protected:
     // Variables added for incremental mode
     int incremental; // Use incremental SAT Solver
     int nbVarsInitialFormula; // nb VAR in formula without assumptions (incremental SAT)
+
+    // Transitivity theory (pairwise graph coloring encodings): s_ij & s_jk -> s_ik for all the triples
+    // of pair variables, propagated by scanning the rows of the pair index instead of ternary clauses.
+    int                 transitivityVertices; // 0 when the theory is off
+    const msp::PairIndex* transitivityIndex;  // variable of each pair
+    vec<int>            transitivityEnds;     // the pair (i,j) of each variable at 2v and 2v+1, -1 for the other variables
+    vec<Lit>            theoryReasons;        // the false literals of the triple which implied each variable,
+                                              // lit_Undef once the variable is unassigned
+    CRef                theoryConflict;       // the violated triple returned by propagate(), freed after its analysis
     double totalTime4Sat,totalTime4Unsat;
     int nbSatCalls,nbUnsatCalls;
     vec<int> assumptionPositions,initialPositions;
@@ -418,6 +457,9 @@ protected:
     void     newDecisionLevel ();                                                      // Begins a new decision level.
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
+    void     theoryEnqueue    (Lit p, Lit a, Lit b);                                   // Enqueue p, implied by the triple (p v a v b) of the transitivity theory.
+    CRef     propagateTransitivity(Lit p);                                             // Propagates the triples of the pair variable of p, returns a conflict or CRef_Undef.
+    CRef     reasonClause     (Var x);                                                 // Same as reason(), but builds the clause of a theory implication on first use.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
     CRef     propagateUnaryWatches(Lit p);                                                  // Perform propagation on unary watches of p, can find only conflicts
     void     analyze          (CRef confl, vec<Lit>& out_learnt, vec<Lit> & selectors, int& out_btlevel,unsigned int &nblevels,unsigned int &szWithoutSelectors);    // (bt = backtrack)
@@ -447,9 +489,11 @@ protected:
     void     attachClausePurgatory(CRef cr);
     void     removeClause     (CRef cr, bool inPurgatory = false);               // Detach and free a clause.
     bool     locked           (const Clause& c) const; // Returns TRUE if a clause is a reason for some implication in the current state.
+    Lit      lockedLit        (const Clause& c) const; // Returns the literal a clause is the reason of, lit_Undef if none.
     bool     satisfied        (const Clause& c) const; // Returns TRUE if a clause is satisfied in the current state.
 
     template <typename T> unsigned int computeLBD(const T & lits,int end=-1);
+    void     updateLBD        (CRef cr);                                               // Dynamic LBD of a learnt clause seen in conflict analysis
     void minimisationWithBinaryResolution(vec<Lit> &out_learnt);
 
     virtual void     relocAll         (ClauseAllocator& to);
@@ -522,14 +566,15 @@ inline bool     Solver::addEmptyClause  ()                      { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p)                 { add_tmp.clear(); add_tmp.push(p); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
- inline bool     Solver::locked          (const Clause& c) const { 
-   if(c.size()>2) 
-     return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; 
-   return 
-     (value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c)
-     || 
-     (value(c[1]) == l_True && reason(var(c[1])) != CRef_Undef && ca.lea(reason(var(c[1]))) == &c);
+ // The implied literal of a reason is c[0], except for binary clauses and the clauses of size 3
+ // propagated through watchesTer, where it can be any of them.
+ inline Lit      Solver::lockedLit       (const Clause& c) const { 
+   int n = c.size() > 3 ? 1 : c.size();
+   for(int i = 0; i < n; i++)
+     if(value(c[i]) == l_True && reason(var(c[i])) < CRef_Lazy && ca.lea(reason(var(c[i]))) == &c) return c[i];
+   return lit_Undef;
  }
+ inline bool     Solver::locked          (const Clause& c) const { return lockedLit(c) != lit_Undef; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
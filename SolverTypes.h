@@ -277,6 +277,7 @@ public:
 
 
     const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
+    const CRef CRef_Lazy  = CRef_Undef - 1; // Reason of a theory implication, built by Solver::reasonClause on demand.
     class ClauseAllocator : public RegionAllocator<uint32_t>
     {
         static int clauseWord32Size(int size, int extra_size){
@@ -0,0 +1,77 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#include "TriangleSet.h"
+#include <algorithm>
+#include <string.h>
+
+namespace msp {
+
+  void TriangleSet::grow()
+  {
+    size_t capacity = table.empty() ? 1024 : 2 * table.size();
+    while (capacity < 2 * (triangles.size() + 1)) capacity *= 2;
+
+    table.assign(capacity, 0);
+
+    uint64_t mask = table.size() - 1;
+
+    for (uint32_t t = 0; t < triangles.size(); t++)
+    {
+      uint64_t h = hash(triangles[t].i, triangles[t].j, triangles[t].k) & mask;
+      while (table[h] != 0) h = (h + 1) & mask;
+      table[h] = t + 1;
+    }
+  }
+
+  bool TriangleSet::insert(uint32_t a, uint32_t b, uint32_t c)
+  {
+    if (a > b) std::swap(a, b);
+    if (b > c) std::swap(b, c);
+    if (a > b) std::swap(a, b);
+
+    // keep the load factor under 1/2
+    if (2 * (triangles.size() + 1) > table.size()) grow();
+
+    uint64_t mask = table.size() - 1;
+    uint64_t h = hash(a, b, c) & mask;
+
+    for (; table[h] != 0; h = (h + 1) & mask)
+    {
+      const Triangle& t = triangles[table[h] - 1];
+      if (t.i == a && t.j == b && t.k == c) return false;
+    }
+
+    Triangle t = { a, b, c };
+    triangles.push_back(t);
+    table[h] = triangles.size();
+
+    return true;
+  }
+
+  void TriangleSet::assign(const uint32_t* data, size_t n)
+  {
+    clear();
+
+    // the triangles are already sorted and distinct, the table is only built by the next insert()
+    triangles.resize(n);
+    if (n) memcpy(triangles.data(), data, n * sizeof(Triangle));
+  }
+
+}
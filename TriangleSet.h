@@ -0,0 +1,86 @@
+/****************************************************************************************
+ *
+ * This file is part of Graph Coloring
+ *
+ * Graph Coloring is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Graph Coloring is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Graph Coloring.
+ * If not, see http://www.gnu.org/licenses/.
+ *
+ * Contributors:
+ *       - Valentin Montmirail (valentin.montmirail@univ-cotedazur.fr)
+ ***************************************************************************************************/
+
+#ifndef TRIANGLE_SET_H
+#define TRIANGLE_SET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace msp {
+
+  /** @brief A triangle of the chordalization, with i < j < k. */
+  struct Triangle {
+    uint32_t i, j, k;
+  };
+
+  static_assert(sizeof(Triangle) == 3 * sizeof(uint32_t), "Triangle is written as-is in the snapshots");
+
+  /**
+   * @brief The triangles of the chordalization, stored contiguously in insertion order.
+   *
+   * Duplicates are rejected through an open-addressing table holding indices into the array.
+   */
+  class TriangleSet {
+
+  private:
+
+    std::vector<Triangle> triangles;
+
+    /** @brief linear probing table, 0 is an empty slot, otherwise the index of a triangle plus one */
+    std::vector<uint32_t> table;
+
+    static inline uint64_t hash(uint32_t i, uint32_t j, uint32_t k)
+    {
+      uint64_t h = ((uint64_t)i << 32 | j) * 0x9E3779B97F4A7C15ULL;
+      h ^= (h >> 29) ^ k;
+      h *= 0xBF58476D1CE4E5B9ULL;
+      return h ^ (h >> 32);
+    }
+
+    void grow();
+
+  public:
+
+    /** Adds the triangle {a,b,c} (in any order), returns false if it was already there. */
+    bool insert(uint32_t a, uint32_t b, uint32_t c);
+
+    /** Replaces the content by n distinct triangles given as sorted triples (e.g. read from a snapshot). */
+    void assign(const uint32_t* data, size_t n);
+
+    void clear() { std::vector<Triangle>().swap(triangles); std::vector<uint32_t>().swap(table); }
+
+    inline size_t size() const { return triangles.size(); }
+
+    inline bool empty() const { return triangles.empty(); }
+
+    inline const Triangle* data() const { return triangles.data(); }
+
+    inline const Triangle* begin() const { return triangles.data(); }
+
+    inline const Triangle* end() const { return triangles.data() + triangles.size(); }
+
+    inline const Triangle& operator[](size_t index) const { return triangles[index]; }
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,40 @@
+#!/bin/sh
+# Usage: tests/run.sh <graphcoloring binary>
+# Checks the number of colors found on the graphs of this folder, with and without a triangulation.
+
+BIN=$1
+DIR=$(dirname "$0")
+FAILED=0
+
+# check <expected colors, or none if the formula is unsatisfiable> <graph> <options...>
+check()
+{
+	expected=$1; graph=$2; shift 2
+	found=$("$BIN" "$@" "$DIR/$graph" | sed -n -e 's/^o \([0-9]*\) colors$/\1/p' -e 's/^s UNSATISFIABLE$/none/p')
+
+	if [ "$found" = "$expected" ]; then
+		echo "ok     $graph $*"
+	else
+		echo "FAILED $graph $*: $expected colors expected, got '$found'"
+		FAILED=1
+	fi
+}
+
+check 3 c5.col
+check 3 c5.col -t
+check 3 c5.col -t=min-degree
+check 3 c5.col -t=mcs-m
+check 3 c5.col -t=lex-m
+check 3 c5.col -t -native
+
+check 3 c5.col -enc=assignment
+check none c5.col -enc=assignment -colors=2
+
+check 4 myciel3.col
+check 4 myciel3.col -t
+check 4 myciel3.col -t=min-fill-degree
+
+check 3 c5-isolated.graph
+check 3 c5-metis.txt
+
+exit $FAILED
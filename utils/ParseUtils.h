@@ -56,10 +56,27 @@ public:
 
 
 //-------------------------------------------------------------------------------------------------
-// End-of-file detection functions for StreamBuffer and char*:
+// A character stream over a memory region (e.g. a memory-mapped file), no copy is performed:
+
+class MemoryBuffer {
+    const char*   pos;
+    const char*   end;
+
+public:
+    MemoryBuffer(const char* b, size_t len) : pos(b), end(b + len) { }
+
+    int         operator *  () const { return (pos >= end) ? EOF : (unsigned char)*pos; }
+    void        operator ++ ()       { pos++; }
+    const char* position    () const { return pos; }
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// End-of-file detection functions for StreamBuffer, MemoryBuffer and char*:
 
 
 static inline bool isEof(StreamBuffer& in) { return *in == EOF;  }
+static inline bool isEof(MemoryBuffer& in) { return *in == EOF;  }
 static inline bool isEof(const char*   in) { return *in == '\0'; }
 
 //-------------------------------------------------------------------------------------------------